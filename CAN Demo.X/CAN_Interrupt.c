@@ -21,9 +21,9 @@
 *************************************************************************/
 void __interrupt () isr (void)
 {
-    if (TICK_TIMER_INT_FLAG) // Permanently enabled therefore no need to check enable flag
+    if (TICK_TIMER_INT_ENABLE && TICK_TIMER_INT_FLAG) // disabled while no timer is running
     {
-        sendMsg(MSG_ONE_MILLISECOND);
+        timerTick();
         TICK_TIMER_INT_FLAG = 0; 
     }
 }
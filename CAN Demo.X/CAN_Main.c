@@ -45,7 +45,7 @@ int main(void)
         msg = getMsg();
         switch (msg)
         {
-            case MSG_ONE_MILLISECOND:
+            case MSG_TIMER_EXPIRED:
                 timerRoutine();
                 break;
         }            
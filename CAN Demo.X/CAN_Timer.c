@@ -13,30 +13,50 @@
 
 static U8 patternCount = 0;
 
+#define NO_TIMER        U8_MAX
+
+/*  The running timers are kept in a list sorted by expiry. Each timer holds
+    the number of ticks between its expiry and that of the timer before it,
+    so only the head of the list is counted down. While the list is running
+    the head's count lives in headCountdown, which the tick interrupt
+    decrements; the interrupt only posts a message when the head expires,
+    and the tick interrupt is left disabled when no timer is running */
+
 typedef struct timer_t
 {
-    uint16_t timer;
+    uint16_t delta;
     uint16_t timeout;
+    uint8_t next;
     void (*onTimeout)(void);
 }
 timer_t;
 
 static timer_t timers[NUM_TIMERS] = 
 {
-    { 0, 0, debugTimer},
-    { 0, 0, powerOnTimer},
-    { 0, 0, powerOffTimer},
-    { 0, 0, patternOnTimer},
-    { 0, 0, patternOffTimer},
+    { 0, 0, NO_TIMER, debugTimer},
+    { 0, 0, NO_TIMER, powerOnTimer},
+    { 0, 0, NO_TIMER, powerOffTimer},
+    { 0, 0, NO_TIMER, patternOnTimer},
+    { 0, 0, NO_TIMER, patternOffTimer},
 };
 
+static uint8_t headTimer = NO_TIMER;            // the next timer to expire
+static volatile uint16_t headCountdown = 0;     // ticks until the head timer expires
+
+static void stopTick(void);
+static void startTick(void);
+static void restartTickIfIdle(void);
+static void insertTimer(uint8_t timerIdx, uint16_t ticks);
+static void removeTimer(uint8_t timerIdx);
+
 /**********************************************************************//*
 * FUNCTION     	: systemTickInit
 * AUTHOR       	: Martyn Carribine
 * INPUTS        : void
 * OUTPUTS      	: none
 * RETURNS      	: void
-* DESCRIPTION  	: Initialises a one millisecond 'tick' timer 
+* DESCRIPTION  	: Initialises a one millisecond 'tick' timer. The tick
+*                 interrupt is enabled when the first timer is set.
 *
 *************************************************************************/
 
@@ -53,7 +73,33 @@ void systemTickInit(void)
 #endif // PLL_ENABLED    
     
     TICK_TIMER_INT_FLAG = 0;
-    TICK_TIMER_INT_ENABLE = 1;
+    TICK_TIMER_INT_ENABLE = 0;
+}
+
+/**********************************************************************//*
+* FUNCTION     	: timerTick
+* AUTHOR       	: Martyn Carribine
+* INPUTS        : void
+* OUTPUTS      	: none
+* RETURNS      	: void
+* DESCRIPTION  	: called from the tick interrupt. Counts down the head
+*                 timer and, when it expires, stops the tick and posts
+*                 MSG_TIMER_EXPIRED for timerRoutine
+*
+*************************************************************************/
+
+void timerTick(void)
+{
+    if (headCountdown > 0)
+    {
+        headCountdown--;
+    }
+
+    if (0 == headCountdown)
+    {
+        TICK_TIMER_INT_ENABLE = 0;
+        sendMsg(MSG_TIMER_EXPIRED);
+    }
 }
 
 /**********************************************************************//*
@@ -62,29 +108,31 @@ void systemTickInit(void)
 * INPUTS        : void
 * OUTPUTS      	: none
 * RETURNS      	: void
-* DESCRIPTION  	: updates all timers at the tick rate and executes the appropriate function on timeout
+* DESCRIPTION  	: executes the appropriate function for each expired
+*                 timer and restarts the tick for the next one
 *
 *************************************************************************/
 
 void timerRoutine(void)
 {
-
     uint8_t i;
-    //reset the interrupt flag
-    //process the tick timer
-    for (i = 0; i < NUM_TIMERS; i++)
+
+    stopTick();
+    while ((NO_TIMER != headTimer) && (0 == timers[headTimer].delta))
     {
-        if (timers[i].timer > 0)
+        i = headTimer;
+        headTimer = timers[i].next;
+        timers[i].next = NO_TIMER;
+        if (NO_TIMER != headTimer)
         {
-            timers[i].timer--;
-
-            if (0 == timers[i].timer)
-            {
-                timers[i].onTimeout();
-            }
+            headCountdown = timers[headTimer].delta;
         }
-    }
 
+        // the timeout function may set timers, which restarts the tick
+        timers[i].onTimeout();
+        stopTick();
+    }
+    startTick();
 }
 /**********************************************************************//*
 * FUNCTION     	: setTimer
@@ -92,19 +140,19 @@ void timerRoutine(void)
 * INPUTS        : void
 * OUTPUTS      	: none
 * RETURNS      	: void
-* DESCRIPTION  	: Loads a timer
+* DESCRIPTION  	: Loads a timer. A timeout of zero stops the timer.
 *
 *************************************************************************/
 
 void setTimer(timerIdx_t timerIdx, uint16_t timeout)
 {
-    timer_t* pTimer = timers + timerIdx;
-
-    // disable timer interrupt while setting timeout value
-    TICK_TIMER_INT_ENABLE = 0;
-    pTimer->timer = timeout;
-    pTimer->timeout = timeout;
-    TICK_TIMER_INT_ENABLE = 1;
+    // stop the tick while the list is changed
+    stopTick();
+    removeTimer(timerIdx);
+    restartTickIfIdle();
+    timers[timerIdx].timeout = timeout;
+    insertTimer(timerIdx, timeout);
+    startTick();
 }
 /**********************************************************************//*
 * FUNCTION     	: resetTimer
@@ -118,12 +166,12 @@ void setTimer(timerIdx_t timerIdx, uint16_t timeout)
 
 void resetTimer(timerIdx_t timerIdx)
 {
-    timer_t* pTimer = timers + timerIdx;
-
-    // disable timer interrupt while setting timeout value
-    TICK_TIMER_INT_ENABLE = 0;
-    pTimer->timer = pTimer->timeout;
-    TICK_TIMER_INT_ENABLE = 1;
+    // stop the tick while the list is changed
+    stopTick();
+    removeTimer(timerIdx);
+    restartTickIfIdle();
+    insertTimer(timerIdx, timers[timerIdx].timeout);
+    startTick();
 }
 
 /**********************************************************************//*
@@ -138,10 +186,164 @@ void resetTimer(timerIdx_t timerIdx)
 
 void stopTimer(timerIdx_t timerIdx)
 {
-    // disable timer interrupt while setting timeout value
+    // stop the tick while the list is changed
+    stopTick();
+    removeTimer(timerIdx);
+    startTick();
+}
+
+/**********************************************************************//*
+* FUNCTION     	: stopTick
+* AUTHOR       	: Martyn Carribine
+* INPUTS        : void
+* OUTPUTS      	: none
+* RETURNS      	: void
+* DESCRIPTION  	: disables the tick interrupt and saves the head timer's
+*                 remaining count back into the list
+*
+*************************************************************************/
+
+static void stopTick(void)
+{
     TICK_TIMER_INT_ENABLE = 0;
-    timers[timerIdx].timer = 0;
-    TICK_TIMER_INT_ENABLE = 1;
+    if (NO_TIMER != headTimer)
+    {
+        timers[headTimer].delta = headCountdown;
+    }
+}
+
+/**********************************************************************//*
+* FUNCTION     	: startTick
+* AUTHOR       	: Martyn Carribine
+* INPUTS        : void
+* OUTPUTS      	: none
+* RETURNS      	: void
+* DESCRIPTION  	: loads the head timer's count and enables the tick
+*                 interrupt, leaving it disabled when no timer is running
+*
+*************************************************************************/
+
+static void startTick(void)
+{
+    if (NO_TIMER != headTimer)
+    {
+        // a head count of zero has already expired and is either being
+        // handled by timerRoutine or has its message queued
+        headCountdown = timers[headTimer].delta;
+        if (headCountdown > 0)
+        {
+            TICK_TIMER_INT_ENABLE = 1;
+        }
+    }
+}
+
+/**********************************************************************//*
+* FUNCTION     	: restartTickIfIdle
+* AUTHOR       	: Martyn Carribine
+* INPUTS        : void
+* OUTPUTS      	: none
+* RETURNS      	: void
+* DESCRIPTION  	: restarts the tick period when no timer is running, so
+*                 a flag left pending while idle is not counted as a tick
+*
+*************************************************************************/
+
+static void restartTickIfIdle(void)
+{
+    if (NO_TIMER == headTimer)
+    {
+        TICK_TIMER = 0;
+        TICK_TIMER_INT_FLAG = 0;
+    }
+}
+
+/**********************************************************************//*
+* FUNCTION     	: insertTimer
+* AUTHOR       	: Martyn Carribine
+* INPUTS        : uint8_t timerIdx - the timer, not in the list
+*                 uint16_t ticks - ticks until the timer expires
+* OUTPUTS      	: none
+* RETURNS      	: void
+* DESCRIPTION  	: adds a timer to the sorted list, after any timers
+*                 that expire at the same tick. Zero ticks is ignored.
+*
+*************************************************************************/
+
+static void insertTimer(uint8_t timerIdx, uint16_t ticks)
+{
+    uint8_t prev = NO_TIMER;
+    uint8_t cur = headTimer;
+
+    if (0 == ticks)
+    {
+        return;
+    }
+
+    while ((NO_TIMER != cur) && (ticks >= timers[cur].delta))
+    {
+        ticks -= timers[cur].delta;
+        prev = cur;
+        cur = timers[cur].next;
+    }
+
+    timers[timerIdx].delta = ticks;
+    timers[timerIdx].next = cur;
+    if (NO_TIMER != cur)
+    {
+        timers[cur].delta -= ticks;
+    }
+
+    if (NO_TIMER == prev)
+    {
+        headTimer = timerIdx;
+    }
+    else
+    {
+        timers[prev].next = timerIdx;
+    }
+}
+
+/**********************************************************************//*
+* FUNCTION     	: removeTimer
+* AUTHOR       	: Martyn Carribine
+* INPUTS        : uint8_t timerIdx - the timer
+* OUTPUTS      	: none
+* RETURNS      	: void
+* DESCRIPTION  	: removes a timer from the sorted list, if it is running
+*
+*************************************************************************/
+
+static void removeTimer(uint8_t timerIdx)
+{
+    uint8_t prev = NO_TIMER;
+    uint8_t cur = headTimer;
+
+    while ((NO_TIMER != cur) && (timerIdx != cur))
+    {
+        prev = cur;
+        cur = timers[cur].next;
+    }
+
+    if (NO_TIMER == cur)
+    {
+        return;
+    }
+
+    cur = timers[timerIdx].next;
+    if (NO_TIMER != cur)
+    {
+        timers[cur].delta += timers[timerIdx].delta;
+    }
+
+    if (NO_TIMER == prev)
+    {
+        headTimer = cur;
+    }
+    else
+    {
+        timers[prev].next = cur;
+    }
+    timers[timerIdx].next = NO_TIMER;
 }
 
 /**********************************************************************//*
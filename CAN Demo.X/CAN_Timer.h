@@ -35,6 +35,7 @@ typedef enum timerIdx_t {
 } timerIdx_t;
 
 void systemTickInit(void);
+void timerTick(void);
 void timerRoutine(void);
 void setTimer(timerIdx_t timerIdx, uint16_t timeout);
 void resetTimer(timerIdx_t timerIdx);
@@ -10,10 +10,12 @@
  ******************************************************************/
 #include "SYS_H.h"
 
+#define MSG_PAYLOAD_SIZE 8      // the data of one CAN frame
+
 typedef enum msgType_t
 {
     MSG_NOT_AVAILABLE = 0x0,
-    MSG_ONE_MILLISECOND,
+    MSG_TIMER_EXPIRED,
 } msgType_t;
 
 #endif	/* CFG_Message */
@@ -16,22 +16,31 @@
 #define MSG_QUEUE_SIZE 8
 #define MSG_QUEUE_SIZE_MASK 0b111
 
-// buffer of GIE flag for PICs
-U8 GIEBuffer;
+typedef struct msgSlot_t
+{
+    uint8_t msg;
+    uint8_t length;
+    uint8_t payload[MSG_PAYLOAD_SIZE];
+}
+msgSlot_t;
 
-static uint8_t the_msgQueue[MSG_QUEUE_SIZE];    // the message queue
+static volatile msgSlot_t the_msgQueue[MSG_QUEUE_SIZE];    // the message queue
 
-/* 	By using single byte values we can be sure of atomic updates. At any
-	time the_msgPutIndex is the index at which the next message will be put
-	and the_msgGetIndex is the index from which the next message will be read.
-	If they are equal then the queue is empty and if, allowing for wrapping,
-	the_msgPutIndex + 1 == the_msgGetIndex then the queue is full. Note that
-	this will always leave one slot empty */
+/* 	The queue has a single producer, the interrupt, and a single consumer,
+	the main loop, so no critical sections are needed. the_msgPutIndex is
+	only written by the producer and the_msgGetIndex only by the consumer.
+	Both count freely and are masked to index the queue; by using single
+	byte values we can be sure of atomic updates. If they are equal then the
+	queue is empty and if the_msgPutIndex - the_msgGetIndex == MSG_QUEUE_SIZE
+	then the queue is full. A slot is filled before the_msgPutIndex is moved
+	past it and emptied before the_msgGetIndex is moved past it */
 
-static int the_msgPutIndex = 0;   // where to put the next incoming message
-static uint8_t the_msgGetIndex = 0;   // where to get the next outgoing message
+static volatile uint8_t the_msgPutIndex = 0;   // where to put the next incoming message
+static volatile uint8_t the_msgGetIndex = 0;   // where to get the next outgoing message
 
-//static bool_t the_queueOverflowed = FALSE;
+static volatile uint8_t the_msgOverflowCount = 0;  // messages dropped, written by the producer
+static uint8_t the_msgOverflowCleared = 0;         // overflow count when last cleared
+static uint8_t the_msgPeakDepth = 0;               // most messages seen waiting
 
 
 /************************************************************************
@@ -41,7 +50,7 @@ static uint8_t the_msgGetIndex = 0;   // where to get the next outgoing message
 * INPUTS        : none
 * OUTPUTS       : none
 * RETURNS       : none
-* DESCRIPTION   : Resets the queue.
+* DESCRIPTION   : Resets the queue. Call before interrupts are enabled.
 *
 *************************************************************************/
 void initMsgQueue( void )
@@ -50,30 +59,68 @@ void initMsgQueue( void )
 	
     for (i=0; i<MSG_QUEUE_SIZE; i++)
     {
-        the_msgQueue[i] = MSG_NOT_AVAILABLE;
+        the_msgQueue[i].msg = MSG_NOT_AVAILABLE;
+        the_msgQueue[i].length = 0;
     }
 
     the_msgPutIndex = 0;
     the_msgGetIndex = 0;
-//    the_queueOverflowed = FALSE;
+    the_msgOverflowCount = 0;
+    the_msgOverflowCleared = 0;
+    the_msgPeakDepth = 0;
 }
 	
 
 /************************************************************************
 *
-* FUNCTION      : hasMsgQueueOverflowed
+* FUNCTION      : getMsgOverflowCount
+* AUTHOR        : Martyn Carribine
+* INPUTS        : none
+* OUTPUTS       : none
+* RETURNS       : uint8_t - the number of messages dropped because the
+*                 queue was full since the last clear, wrapping at 256
+* DESCRIPTION   : Consumer side only.
+*
+*************************************************************************/
+uint8_t getMsgOverflowCount(void)
+{
+    return (uint8_t)(the_msgOverflowCount - the_msgOverflowCleared);
+}
+
+
+/************************************************************************
+*
+* FUNCTION      : clearMsgOverflowCount
+* AUTHOR        : Martyn Carribine
+* INPUTS        : none
+* OUTPUTS       : none
+* RETURNS       : none
+* DESCRIPTION   : Clears the overflow count and the peak depth. Consumer
+*                 side only, the producer's counter is never written here.
+*
+*************************************************************************/
+void clearMsgOverflowCount(void)
+{
+    the_msgOverflowCleared = the_msgOverflowCount;
+    the_msgPeakDepth = 0;
+}
+
+
+/************************************************************************
+*
+* FUNCTION      : getMsgPeakDepth
 * AUTHOR        : Martyn Carribine
 * INPUTS        : none
 * OUTPUTS       : none
-* RETURNS       : bool_t - TRUE if the message queue has overflowed since
-*                 the last initialisation, otherwise FALSE
-* DESCRIPTION   :
+* RETURNS       : uint8_t - the most messages seen waiting in the queue
+*                 since the last clear
+* DESCRIPTION   : Consumer side only.
 *
 *************************************************************************/
-//bool_t hasMsgQueueOverflowed(void)
-//{
-//    return the_queueOverflowed;
-//}
+uint8_t getMsgPeakDepth(void)
+{
+    return the_msgPeakDepth;
+}
 
 
 /************************************************************************
@@ -83,25 +130,62 @@ void initMsgQueue( void )
 * INPUTS        : uint8_t msg - the message
 * OUTPUTS       : none
 * RETURNS       : none
-* DESCRIPTION   : Pushes message on to the queue.  Messages that arrive
-*                 when the queue is full are just ignored.
+* DESCRIPTION   : Pushes message with no payload on to the queue.
+*                 Producer side only.
 *
 *************************************************************************/
 void sendMsg(uint8_t msg)
 {
-    BUFFER_GLOBAL_INTERRUPT_FLAG_AND_DISABLE;
-    if (1 == GLOBAL_INTERRUPT_ENABLE_FLAG)
+    (void)sendMsgPayload(msg, 0, 0);
+}
+
+
+/************************************************************************
+*
+* FUNCTION      : sendMsgPayload
+* AUTHOR        : Martyn Carribine
+* INPUTS        : uint8_t msg - the message
+*                 const uint8_t *payload - the payload, may be null if
+*                 length is zero
+*                 uint8_t length - the payload length in bytes, at most
+*                 MSG_PAYLOAD_SIZE
+* OUTPUTS       : none
+* RETURNS       : bool_t - TRUE if queued, FALSE if the queue was full
+*                 or the payload too long
+* DESCRIPTION   : Pushes message on to the queue.  Messages that arrive
+*                 when the queue is full are dropped and counted.
+*                 Producer side only.
+*
+*************************************************************************/
+bool_t sendMsgPayload(uint8_t msg, const uint8_t *payload, uint8_t length)
+{
+    uint8_t putIndex = the_msgPutIndex;
+    volatile msgSlot_t *pSlot;
+    uint8_t i;
+
+    if (length > MSG_PAYLOAD_SIZE)
     {
-        do
-        {
-            CLEAR_GLOBAL_INTERRUPT_ENABLE_FLAG;
-        }while (1 == GLOBAL_INTERRUPT_ENABLE_FLAG);
-        SET_GLOBAL_INTERRUPT_ENABLE_FLAG_BUFFER;
+        return FALSE;
+    }
+
+    // Check queue is not full
+    if ((uint8_t)(putIndex - the_msgGetIndex) >= MSG_QUEUE_SIZE)
+    {
+        the_msgOverflowCount++;
+        return FALSE;
     }
 
+    pSlot = the_msgQueue + (putIndex & MSG_QUEUE_SIZE_MASK);
+    for (i = 0; i < length; i++)
+    {
+        pSlot->payload[i] = payload[i];
+    }
+    pSlot->length = length;
+    pSlot->msg = msg;
 
-    the_msgQueue[(the_msgPutIndex++ & MSG_QUEUE_SIZE_MASK)] = msg;
-    BUFFERED_GLOBAL_INTERRUPT_ENABLE;
+    // publish the slot
+    the_msgPutIndex = putIndex + 1;
+    return TRUE;
 }
 
 
@@ -112,26 +196,62 @@ void sendMsg(uint8_t msg)
 * INPUTS        : none
 * OUTPUTS       : none
 * RETURNS       : uint8_t - the message
-* DESCRIPTION   : Pops the oldest message off the front of the queue.
+* DESCRIPTION   : Pops the oldest message off the front of the queue,
+*                 discarding any payload. Consumer side only.
 *
 *************************************************************************/
 uint8_t getMsg(void)
+{
+    return getMsgPayload(0, 0);
+}
+
+
+/************************************************************************
+*
+* FUNCTION      : getMsgPayload
+* AUTHOR        : Martyn Carribine
+* INPUTS        : none
+* OUTPUTS       : uint8_t *payload - receives the payload, at least
+*                 MSG_PAYLOAD_SIZE bytes, may be null
+*                 uint8_t *length - receives the payload length, may be null
+* RETURNS       : uint8_t - the message, or MSG_NOT_AVAILABLE if empty
+* DESCRIPTION   : Pops the oldest message off the front of the queue.
+*                 Consumer side only.
+*
+*************************************************************************/
+uint8_t getMsgPayload(uint8_t *payload, uint8_t *length)
 {
     msgType_t msg = MSG_NOT_AVAILABLE;
-    uint8_t tmpMsgGetIndex = the_msgGetIndex;
+    uint8_t getIndex = the_msgGetIndex;
+    uint8_t depth = (uint8_t)(the_msgPutIndex - getIndex);
+    volatile msgSlot_t *pSlot;
+    uint8_t i;
 
     // Check queue is not empty
-    if (tmpMsgGetIndex != (the_msgPutIndex & MSG_QUEUE_SIZE_MASK))
+    if (depth > 0)
     {
-        msg = the_msgQueue[tmpMsgGetIndex];
-        the_msgQueue[tmpMsgGetIndex] = MSG_NOT_AVAILABLE;
-        ++tmpMsgGetIndex;
+        if (depth > the_msgPeakDepth)
+        {
+            the_msgPeakDepth = depth;
+        }
 
-        // Check for wraparound
-        if (tmpMsgGetIndex >= MSG_QUEUE_SIZE)
-           tmpMsgGetIndex = 0;
+        pSlot = the_msgQueue + (getIndex & MSG_QUEUE_SIZE_MASK);
+        msg = pSlot->msg;
+        if (0 != payload)
+        {
+            for (i = 0; i < pSlot->length; i++)
+            {
+                payload[i] = pSlot->payload[i];
+            }
+        }
+        if (0 != length)
+        {
+            *length = pSlot->length;
+        }
+        pSlot->msg = MSG_NOT_AVAILABLE;
 
-        the_msgGetIndex = tmpMsgGetIndex;
+        // release the slot
+        the_msgGetIndex = getIndex + 1;
     }
 
     return (msg);
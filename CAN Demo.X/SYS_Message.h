@@ -11,8 +11,14 @@
 #include "SYS_H.h"
 #include "CFG_Message.h"
 
+/*  Messages are put by the interrupt and got by the main loop only */
 void initMsgQueue( void );
 void sendMsg(uint8_t msg);
+bool_t sendMsgPayload(uint8_t msg, const uint8_t *payload, uint8_t length);
 U8 getMsg(void);
+U8 getMsgPayload(uint8_t *payload, uint8_t *length);
+U8 getMsgOverflowCount(void);
+void clearMsgOverflowCount(void);
+U8 getMsgPeakDepth(void);
 
 #endif // SYS_Message
@@ -22,6 +22,7 @@
 #include "receiver.h"
 #include "transmitter.h"
 #include "encryption.h"
+#include "page_writer.h"
 #include "bootloader.h"
 
 
@@ -52,6 +53,7 @@ void Bootloader_Reset(const BOOTLOADER_INTERFACE_TABLE *appInterface, uint32_t s
 		Encryption_Reset();
 		Receiver_Reset();
 		Transmitter_Reset();
+		PageWriter_Reset();
 		CanAddress_Reset();
 	}
 	
@@ -80,6 +82,7 @@ void Bootloader_Clock(uint32_t systemTime)
 	Bootloader.systemTime = systemTime;
 	
 	//	clock the modules
+	Transmitter_Clock();
 	Receiver_Clock();
 	CanAddress_Clock();
 
@@ -99,3 +102,68 @@ void Bootloader_Clock(uint32_t systemTime)
 	Bootloader.busy = false;
 }
 
+/**
+  * @brief  Verifies the application image.
+	*					If the verified-image marker matches the application footer CRC32,
+	*					then the image is taken as verified without computing the CRC32.
+	*					Else the CRC32 is computed, and if valid the marker is written.
+	*					This may be called before the bootloader is reset.
+	* @param  appInterface: The application interface table.
+  * @retval True if the application image is valid.
+  */
+bool Bootloader_VerifyApp(const BOOTLOADER_INTERFACE_TABLE *appInterface)
+{
+	const BOOTLOADER_VERIFIED_MARKER *marker;
+	BOOTLOADER_VERIFIED_MARKER newMarker;
+	uint32_t appCRC32;
+	
+	//	validate input
+	if ((NULL == appInterface) || (4 > appInterface->appFlashSize))
+		return false;
+	
+	//	get the footer CRC32, the last word of the application
+	appCRC32 = *(volatile uint32_t *)(uintptr_t)(appInterface->appFlashAddress + appInterface->appFlashSize - 4);
+	
+	//	if the marker matches the footer, then the image is verified
+	marker = (const BOOTLOADER_VERIFIED_MARKER *)(uintptr_t)appInterface->verifiedMarkerAddress;
+	if ((NULL != marker) && (BOOTLOADER_VERIFIED_MARKER_KEY == marker->markerKey)
+		&& (appCRC32 == marker->appCRC32) && (~appCRC32 == marker->appCRC32Complement))
+		return true;
+	
+	//	compute the CRC32
+	if (Bootloader_ComputeCRC32((uint8_t *)(uintptr_t)appInterface->appFlashAddress,
+		appInterface->appFlashSize - 4) != appCRC32)
+		return false;
+	
+	//	write the marker
+	if ((NULL != marker) && (NULL != appInterface->flashWrite))
+	{
+		newMarker.markerKey = BOOTLOADER_VERIFIED_MARKER_KEY;
+		newMarker.appCRC32 = appCRC32;
+		newMarker.appCRC32Complement = ~appCRC32;
+		newMarker.reserved_0 = 0;
+		appInterface->flashWrite(appInterface->verifiedMarkerAddress, &newMarker, sizeof(BOOTLOADER_VERIFIED_MARKER));
+	}
+	return true;
+}
+
+/**
+  * @brief  Clears the verified-image marker, if set, so that the next cold boot
+	*					computes the application CRC32.
+	* @param  appInterface: The application interface table.
+  * @retval None.
+  */
+void Bootloader_ClearVerifiedMarker(const BOOTLOADER_INTERFACE_TABLE *appInterface)
+{
+	const BOOTLOADER_VERIFIED_MARKER *marker;
+	BOOTLOADER_VERIFIED_MARKER newMarker;
+	
+	//	if the marker is set, then clear it
+	marker = (const BOOTLOADER_VERIFIED_MARKER *)(uintptr_t)appInterface->verifiedMarkerAddress;
+	if ((NULL != marker) && (BOOTLOADER_VERIFIED_MARKER_KEY == marker->markerKey)
+		&& (NULL != appInterface->flashWrite))
+	{
+		memset(&newMarker, 0, sizeof(BOOTLOADER_VERIFIED_MARKER));
+		appInterface->flashWrite(appInterface->verifiedMarkerAddress, &newMarker, sizeof(BOOTLOADER_VERIFIED_MARKER));
+	}
+}
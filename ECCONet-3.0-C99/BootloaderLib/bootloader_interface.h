@@ -51,6 +51,30 @@ typedef struct
 } ECCONET_FLASH_FILE_FOOTER;
 
 
+/**
+  * @brief  A marker written to flash after the application CRC32 is verified,
+	*					so that later cold boots need not compute the CRC32 again.
+	*					The marker is cleared before the application flash is written.
+	*					Since the marker only matches the footer CRC32, an image that is corrupted later
+	*					still passes, so the application should check the image in the background and
+	*					clear the marker on a mismatch, see appFirmwareCrcError in the Matrix interface.
+  */
+#define BOOTLOADER_VERIFIED_MARKER_KEY 0x5AFEB007
+typedef struct
+{
+	//	MUST be the identifier key 0x5AFEB007
+	uint32_t markerKey;
+	
+	//	the verified application CRC32, and its complement
+	uint32_t appCRC32;
+	uint32_t appCRC32Complement;
+	
+	//	reserved
+	uint32_t reserved_0;
+
+} BOOTLOADER_VERIFIED_MARKER;
+
+
 
 /**
   * @brief  The bootloader CAN address data file object.
@@ -118,6 +142,13 @@ typedef struct __attribute__((__packed__))
   */
 typedef void (*BOOTLOADER_SEND_CAN_FRAME)(ENET_CAN_FRAME *frame);
 
+/**
+  * @brief  Prototype to try to send a CAN frame to the bus without blocking.
+	* @param  frame: A pointer to the frame to send.
+  * @retval Returns 0 if the frame is accepted for sending, else -1 if the transmitter is busy.
+  */
+typedef int (*BOOTLOADER_TRY_SEND_CAN_FRAME)(ENET_CAN_FRAME *frame);
+
 /**
   * @brief  Prototype for bootloader interface flash write.
   * @param  address: The starting location in flash address space.
@@ -126,6 +157,13 @@ typedef void (*BOOTLOADER_SEND_CAN_FRAME)(ENET_CAN_FRAME *frame);
   * @retval Returns true on success.
   *
   *					Note: Application MUST block until FLASH is written.
+  *					The CAN receive interrupt should stay enabled meanwhile, so that the next
+  *					segment is received while this one is written.  A write that fails is
+  *					reported in the response to the next segment.
+  *					Application writes are whole pages of PAGE_WRITER_PAGE_SIZE bytes on page boundaries,
+  *					so define PAGE_WRITER_PAGE_SIZE to match the flash page size.  If the application
+  *					or staging area does not start or end on a page boundary, then the writes at its
+  *					ends are clipped to the area and are not whole pages.
   */
 typedef bool (*BOOTLOADER_FLASH_WRITE)(uint32_t address, void *data, uint32_t dataSize);
 
@@ -178,6 +216,21 @@ typedef struct
 	//	the method to get the 128-bit device guid
 	BOOTLOADER_GET_GUID get128BitGuid;
 	
+	//	the method to try to send a CAN frame without blocking
+	//	if given, frames are queued and sent from the bootloader clock,
+	//	else frames are sent with the blocking send method
+	BOOTLOADER_TRY_SEND_CAN_FRAME trySendCanFrame;
+	
+	//	the staging flash area for delta updates, which must be at least the application
+	//	flash size and must not overlap the application or bootloader
+	//	you can leave the size zero if delta updates are not supported
+	const uint32_t stagingFlashAddress;
+	const uint32_t stagingFlashSize;
+	
+	//	the flash location of the verified-image marker, which must be in a flash page
+	//	of its own outside the application, see BOOTLOADER_VERIFIED_MARKER
+	//	you can leave this zero to verify the application CRC32 on every cold boot
+	const uint32_t verifiedMarkerAddress;
 
 } BOOTLOADER_INTERFACE_TABLE;
 
@@ -234,4 +287,23 @@ extern bool Bootloader_IsCanAddressValid(void);
   */
 extern uint32_t Bootloader_ComputeCRC32(uint8_t *data, uint32_t length);
 
+/**
+  * @brief  Verifies the application image.
+	*					If the verified-image marker matches the application footer CRC32,
+	*					then the image is taken as verified without computing the CRC32.
+	*					Else the CRC32 is computed, and if valid the marker is written.
+	*					This may be called before the bootloader is reset.
+	* @param  appInterface: The application interface table.
+  * @retval True if the application image is valid.
+  */
+extern bool Bootloader_VerifyApp(const BOOTLOADER_INTERFACE_TABLE *appInterface);
+
+/**
+  * @brief  Clears the verified-image marker, if set, so that the next cold boot
+	*					computes the application CRC32.
+	* @param  appInterface: The application interface table.
+  * @retval None.
+  */
+extern void Bootloader_ClearVerifiedMarker(const BOOTLOADER_INTERFACE_TABLE *appInterface);
+
 #endif  //  __BOOTLOADER_INTERFACE_H
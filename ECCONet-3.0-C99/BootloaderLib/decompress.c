@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    		decompress.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Decompression of compressed flash write segments.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include "decompress.h"
+
+
+/**
+  * @brief  Decompresses a compressed flash write segment.
+	* @param  input: A pointer to the compressed data.
+	* @param  inputSize: The compressed data size.
+	* @param  output: A pointer to a buffer to receive the decompressed data.
+	* @param  outputSize: The output buffer size.
+  * @retval Returns the decompressed data size, or -1 if the data is not valid.
+  */
+int32_t Decompress_Segment(const uint8_t *input, uint16_t inputSize,
+	uint8_t *output, uint16_t outputSize)
+{
+	const uint8_t *inputEnd;
+	uint16_t outputIndex, offset, length;
+	uint8_t control, bit;
+	
+	//	validate input
+	if ((NULL == input) || (NULL == output))
+		return -1;
+	
+	inputEnd = input + inputSize;
+	outputIndex = 0;
+	while (input < inputEnd)
+	{
+		//	get the control byte
+		control = *input++;
+		
+		//	for each item in the group
+		for (bit = 0; (bit < 8) && (input < inputEnd); ++bit, control >>= 1)
+		{
+			//	if a match
+			if (control & 1)
+			{
+				//	get the offset and length
+				if ((inputEnd - input) < 2)
+					return -1;
+				offset = (((uint16_t)input[0] << 4) | (input[1] >> 4)) + 1;
+				length = (input[1] & 0x0F) + DECOMPRESS_MIN_MATCH_LENGTH;
+				input += 2;
+				
+				//	validate the match
+				if ((offset > outputIndex) || ((outputIndex + length) > outputSize))
+					return -1;
+				
+				//	copy the match, a byte at a time since it may overlap
+				while (length--)
+				{
+					output[outputIndex] = output[outputIndex - offset];
+					++outputIndex;
+				}
+			}
+			
+			//	else a literal
+			else
+			{
+				if (outputIndex >= outputSize)
+					return -1;
+				output[outputIndex++] = *input++;
+			}
+		}
+	}
+	return outputIndex;
+}
@@ -0,0 +1,62 @@
+/**
+  ******************************************************************************
+  * @file    		decompress.h
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Decompression of compressed flash write segments.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __DECOMPRESS_H
+#define __DECOMPRESS_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//	compressed segment format
+//
+//	The data is a series of groups, each a control byte followed by up to eight items.
+//	The control byte bits, LSB first, give the item types:
+//
+//	bit     bytes     item
+//  ======================================
+//  0       1         literal byte
+//  1       2         match, big-endian (offset - 1) << 4 | (length - 3)
+//
+//	A match copies length bytes from offset bytes back in the decompressed segment,
+//	so each segment decompresses on its own.
+
+
+//	the maximum decompressed segment size, which should be a multiple of the flash page size
+#define DECOMPRESS_OUTPUT_SIZE  512
+
+//	the match length bias
+#define DECOMPRESS_MIN_MATCH_LENGTH  3
+
+
+/**
+  * @brief  Decompresses a compressed flash write segment.
+	* @param  input: A pointer to the compressed data.
+	* @param  inputSize: The compressed data size.
+	* @param  output: A pointer to a buffer to receive the decompressed data.
+	* @param  outputSize: The output buffer size.
+  * @retval Returns the decompressed data size, or -1 if the data is not valid.
+  */
+extern int32_t Decompress_Segment(const uint8_t *input, uint16_t inputSize,
+	uint8_t *output, uint16_t outputSize);
+
+
+#endif  //  __DECOMPRESS_H
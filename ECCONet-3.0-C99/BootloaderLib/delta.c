@@ -0,0 +1,157 @@
+/**
+  ******************************************************************************
+  * @file    		delta.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Delta firmware updates against the installed application.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ecconet.h"
+#include "bootloader_interface.h"
+#include "bootloader.h"
+#include "delta.h"
+#include "page_writer.h"
+
+
+//	private methods
+static uint32_t GetValue(const uint8_t **data, uint16_t valueSize);
+
+
+/**
+  * @brief  Builds a segment of the new image from a delta segment and the installed image.
+	* @param  input: A pointer to the delta segment.
+	* @param  inputSize: The delta segment size.
+	* @param  output: A pointer to a buffer to receive the new image segment.
+	* @param  outputSize: The output buffer size.
+  * @retval Returns the new image segment size, or -1 if the delta is not valid.
+  */
+int32_t Delta_ApplySegment(const uint8_t *input, uint16_t inputSize,
+	uint8_t *output, uint16_t outputSize)
+{
+	const uint8_t *inputEnd;
+	uint32_t offset;
+	uint16_t outputIndex, length;
+	uint8_t command;
+	
+	//	validate input
+	if ((NULL == input) || (NULL == output))
+		return -1;
+	
+	inputEnd = input + inputSize;
+	outputIndex = 0;
+	while (input < inputEnd)
+	{
+		//	get the command
+		command = *input++;
+		
+		//	if copy from the installed image
+		if (DELTA_COMMAND_COPY == command)
+		{
+			if ((inputEnd - input) < 6)
+				return -1;
+			offset = GetValue(&input, 4);
+			length = GetValue(&input, 2);
+			if (((outputIndex + length) > outputSize)
+				|| (offset > Bootloader.appInterface->appFlashSize)
+				|| (length > (Bootloader.appInterface->appFlashSize - offset)))
+				return -1;
+			memcpy(&output[outputIndex], (uint8_t *)(uintptr_t)(Bootloader.appInterface->appFlashAddress + offset), length);
+		}
+		
+		//	else if insert new bytes
+		else if (DELTA_COMMAND_INSERT == command)
+		{
+			if ((inputEnd - input) < 2)
+				return -1;
+			length = GetValue(&input, 2);
+			if (((outputIndex + length) > outputSize) || (length > (inputEnd - input)))
+				return -1;
+			memcpy(&output[outputIndex], input, length);
+			input += length;
+		}
+		
+		//	else not a valid command
+		else
+		{
+			return -1;
+		}
+		outputIndex += length;
+	}
+	return outputIndex;
+}
+
+/**
+  * @brief  Verifies the staged image, and if valid copies it over the installed image.
+	*					The installed image is not touched unless the staged image footer and CRC are valid,
+	*					and the staged image is kept so that an interrupted install can be repeated.
+	*					The copy goes through the page writer, so it is written in whole flash pages
+	*					clipped to the application area.
+	* @param  None.
+  * @retval Returns a bootloader status code.
+  */
+uint8_t Delta_InstallStagedImage(void)
+{
+	const BOOTLOADER_INTERFACE_TABLE *appInterface = Bootloader.appInterface;
+	const ECCONET_FLASH_FILE_FOOTER *footer;
+	uint32_t errorAddress;
+	
+	//	validate the staging area
+	if ((0 == appInterface->stagingFlashSize) || (appInterface->stagingFlashSize < appInterface->appFlashSize)
+		|| (sizeof(ECCONET_FLASH_FILE_FOOTER) > appInterface->appFlashSize))
+		return BSC_INVALID_FLASH_AREA;
+	if (NULL == appInterface->flashWrite)
+		return BSC_FLASH_WRITE_ERROR;
+	
+	//	verify the staged image footer and CRC
+	footer = (const ECCONET_FLASH_FILE_FOOTER *)(uintptr_t)(appInterface->stagingFlashAddress
+		+ appInterface->appFlashSize - sizeof(ECCONET_FLASH_FILE_FOOTER));
+	if ((ECCONET_FLASH_FILE_FOOTER_KEY != footer->codebaseKey)
+		|| (NULL == appInterface->productInfoStruct)
+		|| (0 != strncmp(footer->modelName, appInterface->productInfoStruct->modelName, 31))
+		|| (Bootloader_ComputeCRC32((uint8_t *)(uintptr_t)appInterface->stagingFlashAddress,
+		appInterface->appFlashSize - 4) != footer->appCRC32))
+		return BSC_VERIFY_ERROR;
+	
+	//	copy the staged image over the installed image in whole pages
+	Bootloader_ClearVerifiedMarker(appInterface);
+	PageWriter_Write(appInterface->appFlashAddress,
+		(const uint8_t *)(uintptr_t)appInterface->stagingFlashAddress, appInterface->appFlashSize);
+	PageWriter_Flush();
+	if (PageWriter_GetWriteError(&errorAddress))
+		return BSC_FLASH_WRITE_ERROR;
+	
+	//	verify the installed image
+	if (Bootloader_ComputeCRC32((uint8_t *)(uintptr_t)appInterface->appFlashAddress,
+		appInterface->appFlashSize - 4) != footer->appCRC32)
+		return BSC_VERIFY_ERROR;
+	return BSC_OK;
+}
+
+
+//	private methods.................................
+
+/**
+  * @brief  Gets a big-endian value from the delta and advances the delta pointer.
+	* @param  data: A pointer to the delta pointer.
+  * @param  valueSize: The value size.
+  * @retval The value.
+  */
+static uint32_t GetValue(const uint8_t **data, uint16_t valueSize)
+{
+	uint32_t value = 0;
+	while (valueSize--)
+		value |= ((uint32_t)*(*data)++ << (8 * valueSize));
+	return value;
+}
@@ -0,0 +1,71 @@
+/**
+  ******************************************************************************
+  * @file    		delta.h
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Delta firmware updates against the installed application.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __DELTA_H
+#define __DELTA_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//	delta segment format
+//
+//	A delta segment is a series of commands that build a segment of the new
+//	application image, which is written to the staging flash area at the same
+//	offset that it will have in the application flash area.
+//	All multi-byte values in big-endian format.
+//
+//	command   bytes               function
+//  ======================================
+//  0         1 + 4 + 2           copy (length) bytes from (offset) in the installed image
+//  1         1 + 2 + length      insert (length) bytes that follow
+//
+//	A delta write with zero data size installs the staged image, see Delta_InstallStagedImage.
+//	Compressed delta segments are not supported.
+
+#define DELTA_COMMAND_COPY		0
+#define DELTA_COMMAND_INSERT	1
+
+
+/**
+  * @brief  Builds a segment of the new image from a delta segment and the installed image.
+	* @param  input: A pointer to the delta segment.
+	* @param  inputSize: The delta segment size.
+	* @param  output: A pointer to a buffer to receive the new image segment.
+	* @param  outputSize: The output buffer size.
+  * @retval Returns the new image segment size, or -1 if the delta is not valid.
+  */
+extern int32_t Delta_ApplySegment(const uint8_t *input, uint16_t inputSize,
+	uint8_t *output, uint16_t outputSize);
+
+/**
+  * @brief  Verifies the staged image, and if valid copies it over the installed image.
+	*					The installed image is not touched unless the staged image footer and CRC are valid,
+	*					and the staged image is kept so that an interrupted install can be repeated.
+	*					The copy goes through the page writer, so it is written in whole flash pages
+	*					clipped to the application area.
+	* @param  None.
+  * @retval Returns a bootloader status code.
+  */
+extern uint8_t Delta_InstallStagedImage(void);
+
+
+#endif  //  __DELTA_H
@@ -39,6 +39,40 @@
 //  7       256 max   44     data
 //  8       2                message checksum
 //	total max bytes = 302 bytes
+//
+//	if the data size has the compressed flag set, then the data is compressed,
+//	the data size less the flag gives the compressed size, and the data location
+//	gives where the decompressed data is written, see "decompress.h"
+#define ENET_COMPRESSED_DATA_SIZE_FLAG	0x8000
+//
+//	if the data size has the delta flag set, then the data is a delta against the installed
+//	application, which builds the new application in the staging flash area, see "delta.h"
+#define ENET_DELTA_DATA_SIZE_FLAG				0x4000
+//
+//	if the data size has the multicast flag set, then the message is part of a multicast update
+#define ENET_MULTICAST_DATA_SIZE_FLAG		0x2000
+//
+//	flash is written after the reply, so a failed write is reported as BSC_FLASH_WRITE_ERROR
+//	in the reply to a later segment, and then in the reply to every segment after it, until the
+//	host restarts the transfer with a segment at or before the failed flash page, such as
+//	the first segment.  A reboot request is answered with the same error instead of rebooting.
+
+
+//	multicast firmware update
+//
+//	1.  The host sends each node a write with the multicast flag and 18 bytes of data,
+//	    a 16-byte session key and the 2-byte number of segments, to join the node to the session.
+//	2.  The host broadcasts writes with the multicast flag, encrypted with the session key
+//	    and with the first session key word as the access code.  The nodes do not reply.
+//	3.  The host sends each node a write with the multicast flag and no data, and the node
+//	    replies with the write response key, a status code, the 2-byte number of segments,
+//	    and a bitmap of the missing segments, LSB first.
+//	4.  The host sends the missing segments to each node with ordinary writes.
+//
+//	The segment index is the offset of the data location in the application flash
+//	divided by the multicast segment size.
+#define ENET_MULTICAST_SEGMENT_SIZE			256
+#define ENET_MULTICAST_JOIN_DATA_SIZE		18
 
 typedef enum
 {
@@ -47,6 +81,8 @@ typedef enum
 	BSC_INVALID_MODEL_NAME,
 	BSC_INVALID_FLASH_AREA,
 	BSC_FLASH_WRITE_ERROR,
+	BSC_DECOMPRESSION_ERROR,
+	BSC_VERIFY_ERROR,
 	
 } BOOTLOADER_STATUS_CODES;
 
@@ -56,10 +92,17 @@ typedef enum
 #define ENET_MAX_SENDER_ADDRESS_FILTER_TIME_MS	 1000
 
 
-//	The CAN identifier HCTP codes
+//	The CAN identifier HCTP codes, the same as the optimized Matrix library codes.
+//	Define ENET_LEGACY_FRAME_TYPES to use the previous codes with older tools.
+#ifdef ENET_LEGACY_FRAME_TYPES
 #define ENET_MESSAGE_FRAME_TYPE_BODY					   0x1C
 #define ENET_MESSAGE_FRAME_TYPE_LAST					   0x1D
 #define ENET_MESSAGE_FRAME_TYPE_SINGLE				   0x1E
+#else
+#define ENET_MESSAGE_FRAME_TYPE_SINGLE				   0x1C
+#define ENET_MESSAGE_FRAME_TYPE_BODY					   0x1D
+#define ENET_MESSAGE_FRAME_TYPE_LAST					   0x1E
+#endif
 
 //	CAN Identifier Bit Widths
 #define ENET_CAN_ID_FRAME_INDEX_BIT_WIDTH			      5
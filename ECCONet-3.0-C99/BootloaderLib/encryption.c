@@ -137,16 +137,66 @@ uint32_t Encryption_GetAccessCode(void)
   */
 void Encryption_Encrypt(uint8_t *data, int32_t dataSize)
 {
-	uint16_t i;
-	uint8_t convolutedKeys[16];
+	Encryption_EncryptWithKey(data, dataSize, Encryption.deviceGuid);
+}
+
+/**
+  * @brief  Encrypts or decrypts a set of data with a given 128-bit key.
+  * @param  data: A pointer to the data to encrypt.
+  * @param  dataSize: The size of the data to encrypt in bytes.
+  * @param  key: An array of four uint32_t that are the 128-bit key.
+  * @retval None.
+  */
+void Encryption_EncryptWithKey(uint8_t *data, int32_t dataSize, const uint32_t key[4])
+{
+	uint16_t i, block;
+	uint8_t convolutedKeys[16], blockMask, *blockKeyBytes;
+	uint32_t keyWords[4], blockKey[4], word;
 	
 	//	get convoluted keys
 	for (i = 0; i < 16; ++i)
-		convolutedKeys[i] = (Encryption.deviceGuid[i >> 2] ^ 0x90208f7f) >> ((i >> 2) << 3);
+		convolutedKeys[i] = (key[i >> 2] ^ 0x90208f7f) >> ((i >> 2) << 3);
+	memcpy(keyWords, convolutedKeys, 16);
 	
-	//	for all data bytes
-	for (i = 0; i < dataSize; ++i)
-		*data++ ^= convolutedKeys[(i ^ (convolutedKeys[(i >> 4) & 0x0f])) & 0x0f];
+	//	for all 16-byte data blocks
+	blockKeyBytes = (uint8_t *)blockKey;
+	for (block = 0; dataSize > 0; ++block)
+	{
+		//	Each block uses the convoluted keys indexed by the byte index exclusive-or'd
+		//	with a block mask.  The upper two mask bits select a key word, and the lower two
+		//	swap the bytes within the word by pairs and by halves.
+		blockMask = convolutedKeys[block & 0x0f] & 0x0f;
+		for (i = 0; i < 4; ++i)
+		{
+			word = keyWords[i ^ (blockMask >> 2)];
+			if (blockMask & 1)
+				word = ((word & 0x00ff00ff) << 8) | ((word >> 8) & 0x00ff00ff);
+			if (blockMask & 2)
+				word = (word << 16) | (word >> 16);
+			blockKey[i] = word;
+		}
+		
+		//	if a whole block, then process a word at a time
+		if (16 <= dataSize)
+		{
+			for (i = 0; i < 4; ++i)
+			{
+				memcpy(&word, data, 4);
+				word ^= blockKey[i];
+				memcpy(data, &word, 4);
+				data += 4;
+			}
+			dataSize -= 16;
+		}
+		
+		//	else process the last bytes
+		else
+		{
+			for (i = 0; i < dataSize; ++i)
+				*data++ ^= blockKeyBytes[i];
+			dataSize = 0;
+		}
+	}
 }
 
 
@@ -84,6 +84,15 @@ extern uint32_t Encryption_GetAccessCode(void);
   */
 extern void Encryption_Encrypt(uint8_t *data, int32_t dataSize);
 
+/**
+  * @brief  Encrypts or decrypts a set of data with a given 128-bit key.
+  * @param  data: A pointer to the data to encrypt.  Must be on 4-byte boundary.
+  * @param  dataSize: The size of the data to encrypt in bytes.
+  * @param  key: An array of four uint32_t that are the 128-bit key.
+  * @retval None.
+  */
+extern void Encryption_EncryptWithKey(uint8_t *data, int32_t dataSize, const uint32_t key[4]);
+
 
 
 #endif  //  __ENCRYPTION_H
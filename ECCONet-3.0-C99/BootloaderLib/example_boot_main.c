@@ -59,6 +59,7 @@ const BOOTLOADER_INTERFACE_TABLE BootloaderInterface_Table =
 	.flashWrite = FlashApi_WriteWithErase256,
 	.reboot = main,
 	.get128BitGuid = FlashApi_ReadUniqueID,
+	.verifiedMarkerAddress = APP_VERIFIED_MARKER_ADDRESS,
 };
 
 /**
@@ -85,9 +86,9 @@ int main(void)
 	}
 	else  //  cold boot
 	{
-		//	if the app CRC is good then proceed to application
-		if (Bootloader_ComputeCRC32((uint8_t*)APP_FLASH_START_ADDRESS, APP_FLASH_SIZE - 4) ==
-			*(volatile uint32_t *)(APP_FLASH_START_ADDRESS + APP_FLASH_SIZE - 4))
+		//	if the app is verified then proceed to application
+		//	the CRC is only computed after an update or if the verified-image marker does not match
+		if (Bootloader_VerifyApp(&BootloaderInterface_Table))
 		{
 			((void (*)(void))(APP_FLASH_START_ADDRESS + 1))();
 		}
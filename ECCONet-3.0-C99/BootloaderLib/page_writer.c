@@ -0,0 +1,171 @@
+/**
+  ******************************************************************************
+  * @file    		page_writer.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Coalesces flash writes into whole flash pages.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "bootloader_interface.h"
+#include "bootloader.h"
+#include "page_writer.h"
+
+
+//	private methods
+static void SetWriteArea(uint32_t address);
+
+
+/**
+  * @brief  The page writer data object.
+  */
+PAGE_WRITER_OBJECT PageWriter;
+
+
+/**
+  * @brief  Resets the page writer.
+  * @param  None.
+  * @retval None.
+  */
+void PageWriter_Reset(void)
+{
+	PageWriter.isPending = false;
+	PageWriter.isWriteError = false;
+	PageWriter.numPageWrites = 0;
+}
+
+/**
+  * @brief  Clocks the page writer, programming a partly written page after an idle time.
+  * @param  None.
+  * @retval None.
+  */
+void PageWriter_Clock(void)
+{
+	if (PageWriter.isPending
+		&& IsBootloaderTimerExpired(PageWriter.lastWriteTime + PAGE_WRITER_IDLE_FLUSH_TIME_MS))
+		PageWriter_Flush();
+}
+
+/**
+  * @brief  Writes data to the page buffer, programming each page as the write moves past it.
+	*					Page bytes that are not written keep their flash contents, and a page is
+	*					only programmed within the application or staging area that holds the data.
+  * @param  address: The starting location in flash address space.
+  * @param  data: A pointer to the data to be written.
+  * @param  dataSize: The number of bytes to be written.
+  * @retval None.
+  */
+void PageWriter_Write(uint32_t address, const uint8_t *data, uint32_t dataSize)
+{
+	uint32_t pageAddress, offset, size;
+	
+	PageWriter.lastWriteTime = Bootloader.systemTime;
+	while (dataSize)
+	{
+		//	if a different page or area, then program the last page and load the new one
+		pageAddress = address & ~(uint32_t)(PAGE_WRITER_PAGE_SIZE - 1);
+		if (!PageWriter.isPending || (pageAddress != PageWriter.pageAddress)
+			|| (address < PageWriter.writeAddress) || (address >= PageWriter.writeEndAddress))
+		{
+			PageWriter_Flush();
+			memcpy(PageWriter.buffer, (uint8_t *)(uintptr_t)pageAddress, PAGE_WRITER_PAGE_SIZE);
+			PageWriter.pageAddress = pageAddress;
+			PageWriter.isPending = true;
+			SetWriteArea(address);
+		}
+		
+		//	add the data to the page
+		offset = address - pageAddress;
+		size = MIN(dataSize, PageWriter.writeEndAddress - address);
+		memcpy(&PageWriter.buffer[offset], data, size);
+		address += size;
+		data += size;
+		dataSize -= size;
+		
+		//	if the page is filled to the end, then program it
+		if (address == PageWriter.writeEndAddress)
+			PageWriter_Flush();
+	}
+}
+
+/**
+  * @brief  Programs the page buffer if it holds unwritten data.
+  * @param  None.
+  * @retval None.
+  */
+void PageWriter_Flush(void)
+{
+	if (!PageWriter.isPending)
+		return;
+	PageWriter.isPending = false;
+	++PageWriter.numPageWrites;
+	if ((NULL == Bootloader.appInterface->flashWrite)
+		|| !Bootloader.appInterface->flashWrite(PageWriter.writeAddress,
+		&PageWriter.buffer[PageWriter.writeAddress - PageWriter.pageAddress],
+		PageWriter.writeEndAddress - PageWriter.writeAddress))
+	{
+		if (!PageWriter.isWriteError || (PageWriter.writeAddress < PageWriter.writeErrorAddress))
+			PageWriter.writeErrorAddress = PageWriter.writeAddress;
+		PageWriter.isWriteError = true;
+	}
+}
+
+/**
+  * @brief  Gets and clears the page write error status.
+  * @param  address: A pointer to a value that receives the lowest failed page address.
+  * @retval True if a page failed to program since the last call.
+  */
+bool PageWriter_GetWriteError(uint32_t *address)
+{
+	bool isWriteError = PageWriter.isWriteError;
+	PageWriter.isWriteError = false;
+	*address = PageWriter.writeErrorAddress;
+	return isWriteError;
+}
+
+
+//	private methods.................................
+
+/**
+  * @brief  Sets the part of the loaded page to program, clipped to the application
+	*					or staging area that holds the given address, so that a page that is not
+	*					aligned to the area does not reprogram the bootloader or other data.
+  * @param  address: A flash address being written in the loaded page.
+  * @retval None.
+  */
+static void SetWriteArea(uint32_t address)
+{
+	const BOOTLOADER_INTERFACE_TABLE *appInterface = Bootloader.appInterface;
+	uint32_t areaAddress, areaEndAddress;
+	
+	//	find the area that holds the address, else the whole page
+	areaAddress = PageWriter.pageAddress;
+	areaEndAddress = PageWriter.pageAddress + PAGE_WRITER_PAGE_SIZE;
+	if ((address >= appInterface->appFlashAddress)
+		&& (address < (appInterface->appFlashAddress + appInterface->appFlashSize)))
+	{
+		areaAddress = appInterface->appFlashAddress;
+		areaEndAddress = appInterface->appFlashAddress + appInterface->appFlashSize;
+	}
+	else if ((address >= appInterface->stagingFlashAddress)
+		&& (address < (appInterface->stagingFlashAddress + appInterface->stagingFlashSize)))
+	{
+		areaAddress = appInterface->stagingFlashAddress;
+		areaEndAddress = appInterface->stagingFlashAddress + appInterface->stagingFlashSize;
+	}
+	
+	//	clip the page to the area
+	PageWriter.writeAddress = MAX(PageWriter.pageAddress, areaAddress);
+	PageWriter.writeEndAddress = MIN(PageWriter.pageAddress + PAGE_WRITER_PAGE_SIZE, areaEndAddress);
+}
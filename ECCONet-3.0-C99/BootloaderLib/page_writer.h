@@ -0,0 +1,112 @@
+/**
+  ******************************************************************************
+  * @file    		page_writer.h
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Coalesces flash writes into whole flash pages.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __PAGE_WRITER_H
+#define __PAGE_WRITER_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//	the flash page size, which must match the app flash write method
+//	define this as a preprocessor symbol for parts with a different page size
+#ifndef PAGE_WRITER_PAGE_SIZE
+#define PAGE_WRITER_PAGE_SIZE  256
+#endif
+#if (0 == PAGE_WRITER_PAGE_SIZE) || (0 != (PAGE_WRITER_PAGE_SIZE & (PAGE_WRITER_PAGE_SIZE - 1)))
+#error "PAGE_WRITER_PAGE_SIZE must be a power of two"
+#endif
+
+//	the time without writes after which a partly written page is programmed
+#define PAGE_WRITER_IDLE_FLUSH_TIME_MS  50
+
+
+/**
+  * @brief  The page writer data object.
+  */
+typedef struct
+{
+	//	the page data
+	uint8_t buffer[PAGE_WRITER_PAGE_SIZE] __attribute__((aligned(4)));
+	
+	//	the page address, and whether the buffer holds unwritten data
+	uint32_t pageAddress;
+	bool isPending;
+	
+	//	the part of the page to program, clipped to the application or staging area
+	uint32_t writeAddress;
+	uint32_t writeEndAddress;
+	
+	//	the time of the last write
+	uint32_t lastWriteTime;
+	
+	//	a page failed to program, and the lowest failed page address, which are held until read
+	bool isWriteError;
+	uint32_t writeErrorAddress;
+	
+	//	the number of pages programmed
+	uint32_t numPageWrites;
+	
+} PAGE_WRITER_OBJECT;
+extern PAGE_WRITER_OBJECT PageWriter;
+
+
+/**
+  * @brief  Resets the page writer.
+  * @param  None.
+  * @retval None.
+  */
+extern void PageWriter_Reset(void);
+
+/**
+  * @brief  Clocks the page writer, programming a partly written page after an idle time.
+  * @param  None.
+  * @retval None.
+  */
+extern void PageWriter_Clock(void);
+
+/**
+  * @brief  Writes data to the page buffer, programming each page as the write moves past it.
+	*					Page bytes that are not written keep their flash contents, and a page is
+	*					only programmed within the application or staging area that holds the data.
+  * @param  address: The starting location in flash address space.
+  * @param  data: A pointer to the data to be written.
+  * @param  dataSize: The number of bytes to be written.
+  * @retval None.
+  */
+extern void PageWriter_Write(uint32_t address, const uint8_t *data, uint32_t dataSize);
+
+/**
+  * @brief  Programs the page buffer if it holds unwritten data.
+  * @param  None.
+  * @retval None.
+  */
+extern void PageWriter_Flush(void);
+
+/**
+  * @brief  Gets and clears the page write error status.
+  * @param  address: A pointer to a value that receives the lowest failed page address.
+  * @retval True if a page failed to program since the last call.
+  */
+extern bool PageWriter_GetWriteError(uint32_t *address);
+
+
+#endif  //  __PAGE_WRITER_H
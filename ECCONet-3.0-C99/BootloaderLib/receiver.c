@@ -25,11 +25,17 @@
 #include "encryption.h"
 #include "transmitter.h"
 #include "receiver.h"
+#include "delta.h"
+#include "page_writer.h"
 
 
 //	private methods
 static void ProcessMessage(void);
-static void AddFrameToBuffer(ENET_CAN_FRAME *frame);
+static void ReceiveFrame(ENET_CAN_FRAME *frame, bool isBroadcast);
+static void AddFrameToBuffer(RECEIVER_BUFFER *buffer, ENET_CAN_FRAME *frame);
+static uint8_t ProcessMulticastRequest(uint16_t dataSize, bool *isReplySent);
+static void MarkMulticastSegments(uint32_t dataLocation, uint16_t dataSize);
+static void CheckPageWriteError(void);
 
 
 /**
@@ -45,10 +51,21 @@ RECEIVER_OBJECT Receiver;
   */
 void Receiver_Reset(void)
 {
+	uint8_t i;
+	
 	//	reset the receiver state
 	Receiver.isReadingInfoFile = false;
-	Receiver.pData = Receiver.buffer;
-	Receiver.messageSize = 0;
+	Receiver.isFlashWriteError = false;
+	Receiver.multicast.isJoined = false;
+	for (i = 0; i < RECEIVER_NUM_BUFFERS; ++i)
+	{
+		Receiver.buffers[i].dataSize = 0;
+		Receiver.buffers[i].messageSize = 0;
+	}
+	Receiver.receiveIndex = 0;
+	Receiver.processIndex = 0;
+	Receiver.message = &Receiver.buffers[0];
+	Receiver.pData = Receiver.message->data;
 }
 
 /**
@@ -59,8 +76,20 @@ void Receiver_Reset(void)
 void Receiver_Clock(void)
 {
 	//	if have new message sent to this device, then process it
-	if (Receiver.messageSize)
+	Receiver.message = &Receiver.buffers[Receiver.processIndex];
+	if (Receiver.message->messageSize)
+	{
 		ProcessMessage();
+		
+		//	free the buffer and process the other buffer next
+		Receiver.message->dataSize = 0;
+		Receiver.message->messageSize = 0;
+		Receiver.processIndex = (Receiver.processIndex + 1) % RECEIVER_NUM_BUFFERS;
+	}
+	
+	//	program any partly written page after an idle time
+	PageWriter_Clock();
+	CheckPageWriteError();
 }
 
 /**
@@ -85,6 +114,13 @@ void Bootloader_ReceiveCanFrame(ENET_CAN_FRAME *frame)
 			token.key = ((uint16_t)frame->data[1] << 8) | frame->data[2];
 			token.value = frame->data[3];
 		}
+		
+		//	else if a multi-frame message from the multicast host, then receive it
+		else if (Receiver.multicast.isJoined
+			&& (frame->idBits.sourceAddress == Receiver.multicast.hostAddress))
+		{
+			ReceiveFrame(frame, true);
+		}
 			
 		//	update CAN address mechanism
 		CanAddress_TokenIn(&token);
@@ -93,39 +129,7 @@ void Bootloader_ReceiveCanFrame(ENET_CAN_FRAME *frame)
 	//	else if message sent just to this device
 	else if (frame->idBits.destinationAddress == Bootloader_GetCanAddress())
 	{
-		//	set source address
-		Receiver.sourceAddress = frame->idBits.sourceAddress;
-
-		//	if receiver buffer is free
-		if (!Receiver.messageSize)
-		{
-			//	if a single frame message
-			if (frame->idBits.frameType == ENET_MESSAGE_FRAME_TYPE_SINGLE)
-			{
-				//	add frame to buffer and set message size
-				memcpy(Receiver.buffer, frame->data, frame->dataSize);
-				Receiver.messageSize = frame->dataSize;
-			}
-
-			//	else if a message body frame
-			else if (frame->idBits.frameType == ENET_MESSAGE_FRAME_TYPE_BODY)
-			{
-				//	add frame to buffer
-				AddFrameToBuffer(frame);
-			}
-
-			//	else a message last frame
-			else if (frame->idBits.frameType == ENET_MESSAGE_FRAME_TYPE_LAST)
-			{
-				//	if receiving a multi-frame message
-				if (((uintptr_t)Receiver.pData - (uintptr_t)Receiver.buffer) >= 8)
-				{
-					//	add frame to buffer and set message size
-					AddFrameToBuffer(frame);
-					Receiver.messageSize = (uintptr_t)Receiver.pData - (uintptr_t)Receiver.buffer;
-				}		
-			}
-		}
+		ReceiveFrame(frame, false);
 	}
 }
 
@@ -169,21 +173,71 @@ uint32_t Receiver_CompareString(const char *string, uint16_t length)
 
 //	private methods.................................
 
+/**
+  * @brief  Receives a frame into the receiver buffer.
+  * @param  frame: The frame to receive.
+  * @param  isBroadcast: True if the frame was broadcast.
+  * @retval None.
+  */
+static void ReceiveFrame(ENET_CAN_FRAME *frame, bool isBroadcast)
+{
+	RECEIVER_BUFFER *buffer;
+	
+	//	if receiver buffer is free
+	buffer = &Receiver.buffers[Receiver.receiveIndex];
+	if (!buffer->messageSize)
+	{
+		//	set source address
+		buffer->sourceAddress = frame->idBits.sourceAddress;
+		buffer->isBroadcast = isBroadcast;
+
+		//	if a single frame message
+		if (frame->idBits.frameType == ENET_MESSAGE_FRAME_TYPE_SINGLE)
+		{
+			//	add frame to buffer and set message size
+			memcpy(buffer->data, frame->data, frame->dataSize);
+			buffer->dataSize = frame->dataSize;
+			buffer->messageSize = frame->dataSize;
+		}
+
+		//	else if a message body frame
+		else if (frame->idBits.frameType == ENET_MESSAGE_FRAME_TYPE_BODY)
+		{
+			//	add frame to buffer
+			AddFrameToBuffer(buffer, frame);
+		}
+
+		//	else a message last frame
+		else if (frame->idBits.frameType == ENET_MESSAGE_FRAME_TYPE_LAST)
+		{
+			//	if receiving a multi-frame message
+			if (buffer->dataSize >= 8)
+			{
+				//	add frame to buffer and set message size
+				AddFrameToBuffer(buffer, frame);
+				buffer->messageSize = buffer->dataSize;
+			}		
+		}
+		
+		//	if the message is complete, then receive into the next buffer
+		if (buffer->messageSize)
+			Receiver.receiveIndex = (Receiver.receiveIndex + 1) % RECEIVER_NUM_BUFFERS;
+	}
+}
+
 /**
   * @brief  Adds frame to receiver buffer.
+  * @param  buffer: The buffer to add the frame to.
   * @param  frame: The frame to add.
   * @retval None.
   */
-static void AddFrameToBuffer(ENET_CAN_FRAME *frame)
+static void AddFrameToBuffer(RECEIVER_BUFFER *buffer, ENET_CAN_FRAME *frame)
 {
-	uint16_t bufferSize;
-	
 	//	if room to add data, then add it
-	bufferSize = (uintptr_t)Receiver.pData - (uintptr_t)Receiver.buffer;
-	if ((bufferSize + frame->dataSize) <= RECEIVER_BUFFER_SIZE)
+	if ((buffer->dataSize + frame->dataSize) <= RECEIVER_BUFFER_SIZE)
 	{
-		memcpy(Receiver.pData, frame->data, frame->dataSize);
-		Receiver.pData += frame->dataSize;
+		memcpy(&buffer->data[buffer->dataSize], frame->data, frame->dataSize);
+		buffer->dataSize += frame->dataSize;
 	}
 }
 
@@ -197,17 +251,19 @@ static void ProcessMessage(void)
 	TOKEN token;
 	uint16_t dataSize;
 	uint32_t dataLocation;
-	bool isInfo;
+	int32_t decodedSize;
+	uint8_t *flashData;
+	bool isInfo, isDelta, isMulticast, isReplySent;
 
-	//	bump back pData
-	Receiver.pData -= 2;
+	//	point to the message checksum
+	Receiver.pData = &Receiver.message->data[Receiver.message->messageSize - 2];
 
 	//	if message has checksum
-	if ((Receiver.messageSize <= 8) ||
-		(Encryption_ComputeCRC16(Receiver.buffer, Receiver.messageSize - 2) == Receiver_GetValue(2)))
+	if ((Receiver.message->messageSize <= 8) ||
+		(Encryption_ComputeCRC16(Receiver.message->data, Receiver.message->messageSize - 2) == Receiver_GetValue(2)))
 	{
 		//	get message key
-		Receiver.pData = &Receiver.buffer[1];
+		Receiver.pData = &Receiver.message->data[1];
 		token.key = Receiver_GetValue(2);
 
 		//	if request for file info or file read
@@ -219,7 +275,7 @@ static void ProcessMessage(void)
 				&& (isInfo || (Receiver_CheckAccessCode())))
 			{
 				Receiver.isReadingInfoFile = !isInfo;
-				Transmitter_SendInfoFileReply(Receiver.sourceAddress, isInfo);
+				Transmitter_SendInfoFileReply(Receiver.message->sourceAddress, isInfo);
 			}
 		}
 		
@@ -235,7 +291,7 @@ static void ProcessMessage(void)
 				//	if segment is zero and valid access code, the send file
 				if ((0 == Receiver_GetValue(2)) && (Receiver_CheckAccessCode()))
 				{
-					Transmitter_SendInfoFileSegmentReply(Receiver.sourceAddress);
+					Transmitter_SendInfoFileSegmentReply(Receiver.message->sourceAddress);
 				}
 			}
 		}
@@ -243,14 +299,23 @@ static void ProcessMessage(void)
 		//	else if request to write flash
 		else if (token.key == KeyRequestFileWriteFixedSegment)
 		{
-			//	decrypt the inner data, less the event index, token, and message checksum
-			Encryption_Encrypt(&Receiver.buffer[3], Receiver.messageSize - (1 + 2 + 2));
+			//	decrypt the inner data, less the event index, token, and message checksum,
+			//	using the session key for multicast segments
+			if (Receiver.message->isBroadcast)
+				Encryption_EncryptWithKey(&Receiver.message->data[3], Receiver.message->messageSize - (1 + 2 + 2),
+					Receiver.multicast.key);
+			else
+				Encryption_Encrypt(&Receiver.message->data[3], Receiver.message->messageSize - (1 + 2 + 2));
 			
 			//	result code
 			token.value = BSC_OK;
+			dataSize = 0;
+			isDelta = false;
+			isReplySent = false;
 			
 			//	validate access code
-			if (Receiver_GetValue(4) != Encryption_GetAccessCode())
+			if (Receiver_GetValue(4) != (Receiver.message->isBroadcast ?
+				Receiver.multicast.key[0] : Encryption_GetAccessCode()))
 				token.value = BSC_INVALID_ACCESS_CODE;
 			
 			//	validate model name
@@ -262,38 +327,230 @@ static void ProcessMessage(void)
 			else
 			{
 				//	get data location and size
-				Receiver.pData = &Receiver.buffer[38];
+				Receiver.pData = &Receiver.message->data[38];
 				dataLocation = Receiver_GetValue(4);
 				dataSize = Receiver_GetValue(2);
-
-				if ((dataLocation < Bootloader.appInterface->appFlashAddress)
-					|| ((dataLocation + dataSize) >
-					(Bootloader.appInterface->appFlashAddress + Bootloader.appInterface->appFlashSize)))
-					token.value = BSC_INVALID_FLASH_AREA;
+				flashData = &Receiver.message->data[44];
+				isMulticast = (0 != (dataSize & ENET_MULTICAST_DATA_SIZE_FLAG));
+				dataSize &= ~ENET_MULTICAST_DATA_SIZE_FLAG;
+				isDelta = (0 != (dataSize & ENET_DELTA_DATA_SIZE_FLAG));
+				decodedSize = 0;
+				
+				//	if a multicast join or missing segments request sent just to this device
+				if (isMulticast && !Receiver.message->isBroadcast)
+				{
+					token.value = ProcessMulticastRequest(dataSize, &isReplySent);
+					dataSize = 0;
+				}
+				
+				//	else if a broadcast that is not a multicast segment
+				else if (Receiver.message->isBroadcast && !isMulticast)
+				{
+					token.value = BSC_INVALID_ACCESS_CODE;
+					dataSize = 0;
+				}
+				
+				//	else if a delta with no data, then install the staged image
+				else if (ENET_DELTA_DATA_SIZE_FLAG == dataSize)
+				{
+					PageWriter_Flush();
+					CheckPageWriteError();
+					token.value = Receiver.isFlashWriteError ? BSC_FLASH_WRITE_ERROR
+						: Delta_InstallStagedImage();
+					dataSize = 0;
+				}
+				
+				//	else a segment to write
+				else
+				{
+					//	if delta data, then build the new image segment
+					if (isDelta)
+					{
+						dataSize &= ~ENET_DELTA_DATA_SIZE_FLAG;
+						decodedSize = ((0 != Bootloader.appInterface->stagingFlashSize)
+							&& ((44 + dataSize + 2) <= Receiver.message->messageSize)) ?
+							Delta_ApplySegment(flashData, dataSize, Receiver.flashData, DECOMPRESS_OUTPUT_SIZE) : -1;
+						dataSize = (uint16_t)decodedSize;
+						flashData = Receiver.flashData;
+					}
 					
-				//	write flash
-				else if ((NULL == Bootloader.appInterface->flashWrite)
-					|| (!Bootloader.appInterface->flashWrite(dataLocation, &Receiver.buffer[44], dataSize)))
-					token.value = BSC_FLASH_WRITE_ERROR;
+					//	else if compressed data, then decompress it
+					else if (dataSize & ENET_COMPRESSED_DATA_SIZE_FLAG)
+					{
+						dataSize &= ~ENET_COMPRESSED_DATA_SIZE_FLAG;
+						decodedSize = ((44 + dataSize + 2) <= Receiver.message->messageSize) ?
+							Decompress_Segment(flashData, dataSize, Receiver.flashData, DECOMPRESS_OUTPUT_SIZE) : -1;
+						dataSize = (uint16_t)decodedSize;
+						flashData = Receiver.flashData;
+					}
+					
+					//	validate decoded data
+					if (0 > decodedSize)
+						token.value = BSC_DECOMPRESSION_ERROR;
+					
+					//	validate area to flash
+					else if ((dataLocation < Bootloader.appInterface->appFlashAddress)
+						|| ((dataLocation + dataSize) >
+						(Bootloader.appInterface->appFlashAddress + Bootloader.appInterface->appFlashSize)))
+						token.value = BSC_INVALID_FLASH_AREA;
+						
+					//	if no flash write method
+					else if (NULL == Bootloader.appInterface->flashWrite)
+						token.value = BSC_FLASH_WRITE_ERROR;
+					
+					else
+					{
+						//	delta segments are written to the staging area
+						if (isDelta)
+							dataLocation += (Bootloader.appInterface->stagingFlashAddress
+								- Bootloader.appInterface->appFlashAddress);
+						
+						//	after a page failed to program, refuse segments until the host
+						//	restarts the transfer at or before the failed page, which rewrites it
+						if (Receiver.isFlashWriteError)
+						{
+							if (dataLocation > Receiver.flashWriteErrorAddress)
+								token.value = BSC_FLASH_WRITE_ERROR;
+							else
+								Receiver.isFlashWriteError = false;
+						}
+					}
+				}
 			}
 			
-			//	send result
-			token.address = Receiver.sourceAddress;
-			token.key = KeyResponseFileWriteFixedSegment;
-			Transmitter_SendToken(&token, 1);
+			//	send result before writing flash, so that the next segment
+			//	is received into the other buffer while this one is written,
+			//	but do not reply to multicast segments
+			if (!Receiver.message->isBroadcast && !isReplySent)
+			{
+				token.address = Receiver.message->sourceAddress;
+				token.key = KeyResponseFileWriteFixedSegment;
+				Transmitter_SendToken(&token, 1);
+			}
+			
+			//	write flash, coalescing the data into whole flash pages
+			if ((BSC_OK == token.value) && dataSize)
+			{
+				//	if writing the application, then clear the verified-image marker
+				//	and mark the multicast segments received
+				if (!isDelta)
+				{
+					Bootloader_ClearVerifiedMarker(Bootloader.appInterface);
+					MarkMulticastSegments(dataLocation, dataSize);
+				}
+				PageWriter_Write(dataLocation, flashData, dataSize);
+				CheckPageWriteError();
+			}
 		}
 		
 		//	else if KeyRequestSystemReboot
 		else if (token.key == KeyRequestSystemReboot)
 		{
-			if ((Receiver_GetValue(4) == (Encryption_GetAccessCode() ^ TOKEN_VALUE_SYSTEM_REBOOT))
-				&& (NULL != Bootloader.appInterface->reboot))
-				Bootloader.appInterface->reboot();
+			PageWriter_Flush();
+			CheckPageWriteError();
+			if (Receiver_GetValue(4) == (Encryption_GetAccessCode() ^ TOKEN_VALUE_SYSTEM_REBOOT))
+			{
+				//	if a page failed to program, then report it instead of rebooting
+				if (Receiver.isFlashWriteError)
+				{
+					token.address = Receiver.message->sourceAddress;
+					token.key = KeyResponseFileWriteFixedSegment;
+					token.value = BSC_FLASH_WRITE_ERROR;
+					Transmitter_SendToken(&token, 1);
+				}
+				else if (NULL != Bootloader.appInterface->reboot)
+					Bootloader.appInterface->reboot();
+			}
 		}
 	}
 	
-	//	clear message size and address
-	Receiver.messageSize = 0;
-	Receiver.pData = Receiver.buffer;
 }
 
+/**
+  * @brief  Processes a multicast join or missing segments request sent just to this device.
+  * @param  dataSize: The request data size, less the multicast flag.
+  * @param  isReplySent: A pointer to a value set true if the reply is sent here.
+  * @retval Returns a bootloader status code.
+  */
+static uint8_t ProcessMulticastRequest(uint16_t dataSize, bool *isReplySent)
+{
+	uint16_t i, numSegments;
+	
+	//	if a join request
+	if ((ENET_MULTICAST_JOIN_DATA_SIZE == dataSize)
+		&& ((44 + ENET_MULTICAST_JOIN_DATA_SIZE + 2) <= Receiver.message->messageSize))
+	{
+		//	get the session key and number of segments
+		Receiver.pData = &Receiver.message->data[44];
+		for (i = 0; i < 4; ++i)
+			Receiver.multicast.key[i] = Receiver_GetValue(4);
+		numSegments = Receiver_GetValue(2);
+		
+		//	validate the number of segments
+		if ((RECEIVER_MAX_MULTICAST_SEGMENTS < numSegments)
+			|| (((uint32_t)numSegments * ENET_MULTICAST_SEGMENT_SIZE) > Bootloader.appInterface->appFlashSize))
+			return BSC_INVALID_FLASH_AREA;
+		
+		//	join the session
+		memset(Receiver.multicast.receivedSegments, 0, sizeof(Receiver.multicast.receivedSegments));
+		Receiver.multicast.numSegments = numSegments;
+		Receiver.multicast.hostAddress = Receiver.message->sourceAddress;
+		Receiver.multicast.isJoined = true;
+		return BSC_OK;
+	}
+	
+	//	else if a missing segments request
+	else if ((0 == dataSize) && Receiver.multicast.isJoined)
+	{
+		PageWriter_Flush();
+		CheckPageWriteError();
+		Transmitter_SendMissingSegmentsReply(Receiver.message->sourceAddress,
+			Receiver.isFlashWriteError ? BSC_FLASH_WRITE_ERROR : BSC_OK,
+			Receiver.multicast.numSegments, Receiver.multicast.receivedSegments);
+		*isReplySent = true;
+		return BSC_OK;
+	}
+	return BSC_INVALID_FLASH_AREA;
+}
+
+/**
+  * @brief  Marks the multicast segments written by a flash write as received.
+  * @param  dataLocation: The flash write location.
+  * @param  dataSize: The flash write size.
+  * @retval None.
+  */
+static void MarkMulticastSegments(uint32_t dataLocation, uint16_t dataSize)
+{
+	uint32_t index, lastIndex;
+	
+	//	if not in a multicast session, then done
+	if (!Receiver.multicast.isJoined || !dataSize)
+		return;
+	
+	//	mark the segments
+	index = (dataLocation - Bootloader.appInterface->appFlashAddress) / ENET_MULTICAST_SEGMENT_SIZE;
+	lastIndex = (dataLocation + dataSize - 1 - Bootloader.appInterface->appFlashAddress) / ENET_MULTICAST_SEGMENT_SIZE;
+	for (; (index <= lastIndex) && (index < Receiver.multicast.numSegments); ++index)
+		Receiver.multicast.receivedSegments[index >> 3] |= (1 << (index & 7));
+}
+
+/**
+  * @brief  Checks for a page that failed to program, which is reported in the response
+	*					to every later segment until the host restarts the transfer at or before the
+	*					lowest failed page.  In a multicast session the segments are all marked missing,
+	*					since the failed page may hold segments already marked received.
+  * @param  None.
+  * @retval None.
+  */
+static void CheckPageWriteError(void)
+{
+	uint32_t address;
+	
+	if (PageWriter_GetWriteError(&address))
+	{
+		if (!Receiver.isFlashWriteError || (address < Receiver.flashWriteErrorAddress))
+			Receiver.flashWriteErrorAddress = address;
+		Receiver.isFlashWriteError = true;
+		memset(Receiver.multicast.receivedSegments, 0, sizeof(Receiver.multicast.receivedSegments));
+	}
+}
@@ -25,30 +25,92 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "matrix_tokens.h"
+#include "decompress.h"
 
 
 #define RECEIVER_BUFFER_SIZE  302
 
+//	the number of receive buffers, so that the next message
+//	can be received while the last one is being written to flash
+#define RECEIVER_NUM_BUFFERS  2
+
+//	the maximum number of segments in a multicast update
+#define RECEIVER_MAX_MULTICAST_SEGMENTS  1024
+
 /**
-  * @brief  The receiver data object.
+  * @brief  A receiver message buffer.
   */
 typedef struct
 {
-	//	reading info file
-	bool isReadingInfoFile;
-	
 	//	the message data
-	uint8_t buffer[RECEIVER_BUFFER_SIZE] __attribute__((aligned(4)));
+	uint8_t data[RECEIVER_BUFFER_SIZE] __attribute__((aligned(4)));
 	
-	//	the message data pointer
-	uint8_t *pData;
+	//	the number of bytes received
+	uint16_t dataSize;
 	
-	//	the message data size in the buffer
+	//	the message data size, or zero if the message is not complete
 	uint16_t messageSize;
 
 	//	the message source address
 	uint16_t sourceAddress;
+	
+	//	the message was broadcast
+	bool isBroadcast;
 
+} RECEIVER_BUFFER;
+
+/**
+  * @brief  The receiver multicast update session.
+  */
+typedef struct
+{
+	//	joined a multicast session
+	bool isJoined;
+	
+	//	the host address
+	uint8_t hostAddress;
+	
+	//	the session key
+	uint32_t key[4];
+	
+	//	the number of segments, and a bitmap of the segments received
+	uint16_t numSegments;
+	uint8_t receivedSegments[RECEIVER_MAX_MULTICAST_SEGMENTS / 8];
+	
+} RECEIVER_MULTICAST;
+
+/**
+  * @brief  The receiver data object.
+  */
+typedef struct
+{
+	//	reading info file
+	bool isReadingInfoFile;
+	
+	//	the message buffers
+	RECEIVER_BUFFER buffers[RECEIVER_NUM_BUFFERS];
+	
+	//	the index of the buffer being received, and of the next buffer to process
+	uint8_t receiveIndex;
+	uint8_t processIndex;
+	
+	//	the buffer being processed
+	RECEIVER_BUFFER *message;
+	
+	//	the message data pointer
+	uint8_t *pData;
+	
+	//	the decompressed data of a compressed segment
+	uint8_t flashData[DECOMPRESS_OUTPUT_SIZE] __attribute__((aligned(4)));
+	
+	//	the multicast update session
+	RECEIVER_MULTICAST multicast;
+	
+	//	a flash page failed to program after its segments were acknowledged,
+	//	and the failed page address, which are held until the host restarts
+	//	the transfer at or before the failed page
+	bool isFlashWriteError;
+	uint32_t flashWriteErrorAddress;
 
 } RECEIVER_OBJECT;
 extern RECEIVER_OBJECT Receiver;
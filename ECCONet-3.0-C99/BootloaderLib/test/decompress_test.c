@@ -0,0 +1,202 @@
+/**
+  ******************************************************************************
+  * @file    		decompress_test.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test of compressed flash write segments.
+	*
+	*							Built and run on the host, from this directory:
+	*							gcc -std=c99 -O2 -I.. -I../.. -o /tmp/decompress_test
+	*								decompress_test.c host_compress.c host_session.c host_flash.c
+	*								../bootloader.c ../receiver.c ../transmitter.c ../encryption.c
+	*								../can_address.c ../decompress.c ../delta.c ../page_writer.c
+	*							/tmp/decompress_test [firmware.bin ...]
+	*
+	*							Each firmware image is compressed into segments, checked to decompress
+	*							to the same data, and flashed raw and compressed in a simulated update
+	*							session to compare the bytes on the wire and the update time.
+	*							Without arguments the test program file itself is used as the image.
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ecconet.h"
+#include "decompress.h"
+#include "host_compress.h"
+#include "host_session.h"
+
+
+//	the compressed segment size, which is the session segment size
+#define COMPRESSED_SIZE   HOST_SESSION_SEGMENT_SIZE
+
+//	checks a test condition
+#define CHECK(condition)  Check((condition), #condition, __LINE__)
+
+
+//	private methods
+static void Check(bool condition, const char *text, int line);
+static void TestInvalidData(void);
+static void TestRoundTrip(const char *name, const uint8_t *data, uint32_t dataSize);
+static void TestSession(const uint8_t *data, uint32_t dataSize);
+
+
+//	the image, and the number of failed checks
+static uint8_t image[HOST_SESSION_APP_SIZE];
+static int numFailures;
+
+
+/**
+  * @brief  Runs the tests.
+  * @param  argc: The number of arguments.
+  * @param  argv: The arguments, which are the firmware image files.
+  * @retval Returns 0 if all tests pass, else 1.
+  */
+int main(int argc, char *argv[])
+{
+	FILE *file;
+	uint32_t imageSize, i, seed = 1;
+	int arg;
+
+	//	invalid compressed data is refused
+	TestInvalidData();
+
+	//	data that does not compress
+	for (i = 0; i < 8192; ++i)
+	{
+		seed = (seed * 1103515245) + 12345;
+		image[i] = (uint8_t)(seed >> 16);
+	}
+	TestRoundTrip("random data", image, 8192);
+
+	//	for each firmware image, or the test program
+	for (arg = (argc > 1) ? 1 : 0; arg < argc; ++arg)
+	{
+		file = fopen(argv[arg], "rb");
+		if (NULL == file)
+		{
+			printf("cannot open %s\n", argv[arg]);
+			++numFailures;
+			continue;
+		}
+		imageSize = fread(image, 1, sizeof(image), file);
+		fclose(file);
+		TestRoundTrip(argv[arg], image, imageSize);
+		TestSession(image, imageSize);
+	}
+
+	if (numFailures)
+	{
+		printf("decompress_test: %d checks failed\n", numFailures);
+		return 1;
+	}
+	printf("decompress_test: all checks passed\n");
+	return 0;
+}
+
+
+//	private methods.................................
+
+/**
+  * @brief  Counts and prints a failed check.
+  * @param  condition: The check condition.
+  * @param  text: The check text.
+  * @param  line: The check line number.
+  * @retval None.
+  */
+static void Check(bool condition, const char *text, int line)
+{
+	if (condition)
+		return;
+	++numFailures;
+	printf("line %d: check failed: %s\n", line, text);
+}
+
+/**
+  * @brief  Checks that invalid compressed data is refused.
+  * @param  None.
+  * @retval None.
+  */
+static void TestInvalidData(void)
+{
+	static const uint8_t matchBeforeStart[] = { 0x02, 'A', 0x00, 0x10 };
+	static const uint8_t truncatedMatch[] = { 0x02, 'A', 0x00 };
+	static const uint8_t literals[] = { 0x00, 'A', 'B', 'C', 'D', 'E' };
+	static const uint8_t longMatch[] = { 0x02, 'A', 0x00, 0x0F };
+	uint8_t output[DECOMPRESS_OUTPUT_SIZE];
+
+	CHECK(-1 == Decompress_Segment(matchBeforeStart, sizeof(matchBeforeStart), output, sizeof(output)));
+	CHECK(-1 == Decompress_Segment(truncatedMatch, sizeof(truncatedMatch), output, sizeof(output)));
+	CHECK(-1 == Decompress_Segment(literals, sizeof(literals), output, 4));
+	CHECK(-1 == Decompress_Segment(longMatch, sizeof(longMatch), output, 8));
+	CHECK(19 == Decompress_Segment(longMatch, sizeof(longMatch), output, sizeof(output)));
+	CHECK(-1 == Decompress_Segment(NULL, 0, output, sizeof(output)));
+}
+
+/**
+  * @brief  Compresses data into segments and checks that each decompresses to the same data.
+  * @param  name: The data name.
+  * @param  data: A pointer to the data.
+  * @param  dataSize: The data size.
+  * @retval None.
+  */
+static void TestRoundTrip(const char *name, const uint8_t *data, uint32_t dataSize)
+{
+	uint8_t compressed[COMPRESSED_SIZE], output[DECOMPRESS_OUTPUT_SIZE];
+	uint32_t offset, totalCompressedSize = 0, numSegments = 0;
+	uint16_t compressedSize, used;
+	int32_t outputSize;
+
+	for (offset = 0; offset < dataSize; offset += used)
+	{
+		compressedSize = HostCompress_Segment(&data[offset], dataSize - offset, DECOMPRESS_OUTPUT_SIZE,
+			compressed, sizeof(compressed), &used);
+		outputSize = Decompress_Segment(compressed, compressedSize, output, sizeof(output));
+		if ((0 == used) || (used != outputSize) || (0 != memcmp(output, &data[offset], used)))
+		{
+			printf("%s: segment at offset %u does not decompress to the same data\n", name, (unsigned)offset);
+			++numFailures;
+			return;
+		}
+		totalCompressedSize += compressedSize;
+		++numSegments;
+	}
+	printf("%s: %u bytes compress to %u bytes (%.1f%%) in %u segments\n", name, (unsigned)dataSize,
+		(unsigned)totalCompressedSize, 100.0 * totalCompressedSize / dataSize, (unsigned)numSegments);
+}
+
+/**
+  * @brief  Flashes an image raw and compressed in simulated update sessions.
+  * @param  data: A pointer to the image.
+  * @param  dataSize: The image size.
+  * @retval None.
+  */
+static void TestSession(const uint8_t *data, uint32_t dataSize)
+{
+	HOST_SESSION_CONFIG config;
+	HOST_SESSION_RESULT raw, compressed;
+
+	memset(&config, 0, sizeof(config));
+	config.image = data;
+	config.imageSize = dataSize;
+	HostSession_Run(&config, &raw);
+	HostSession_Print("raw segments", &raw);
+	CHECK(raw.isRebooted);
+	CHECK(0 == memcmp(HostFlash_Pointer(HOST_SESSION_APP_ADDRESS), data, dataSize));
+
+	config.isCompressed = true;
+	HostSession_Run(&config, &compressed);
+	HostSession_Print("compressed segments", &compressed);
+	CHECK(compressed.isRebooted);
+	CHECK(0 == memcmp(HostFlash_Pointer(HOST_SESSION_APP_ADDRESS), data, dataSize));
+	printf("compressed: %.1f%% of the bytes on the wire, %.1f%% of the update time\n",
+		100.0 * compressed.numWireBytes / raw.numWireBytes, 100.0 * compressed.timeUs / raw.timeUs);
+}
@@ -0,0 +1,337 @@
+/**
+  ******************************************************************************
+  * @file    		delta_test.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test of the delta segment apply and the staged image install.
+	*
+	*							Built and run on the host, from this directory:
+	*							gcc -std=c99 -I.. -I../.. -DPAGE_WRITER_PAGE_SIZE=1024 -o /tmp/delta_test
+	*								delta_test.c host_flash.c ../bootloader.c ../receiver.c ../transmitter.c
+	*								../encryption.c ../can_address.c ../decompress.c ../delta.c ../page_writer.c
+	*							/tmp/delta_test
+	*
+	*							The flash has erase-on-write pages of PAGE_WRITER_PAGE_SIZE bytes, and the
+	*							application area starts and ends off a page boundary.
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include <stdlib.h>
+#include <string.h>
+#include "ecconet.h"
+#include "bootloader_interface.h"
+#include "bootloader.h"
+#include "delta.h"
+#include "page_writer.h"
+#include "host_flash.h"
+
+
+//	the flash layout
+#define APP_ADDRESS       (HOST_FLASH_ADDRESS + 0x300)
+#define APP_SIZE          0xF1A0
+#define STAGING_ADDRESS   (HOST_FLASH_ADDRESS + 0x20000)
+#define STAGING_SIZE      0x10000
+#define MARKER_ADDRESS    (HOST_FLASH_ADDRESS + 0x40000)
+
+//	the delta segment output size, and the block size compared to build the delta
+#define SEGMENT_SIZE      512
+#define BLOCK_SIZE        64
+
+//	checks a test condition
+#define CHECK(condition)  Check((condition), #condition, __LINE__)
+
+
+//	private methods
+static void Check(bool condition, const char *text, int line);
+static void SendCanFrame(ENET_CAN_FRAME *frame);
+static int Reboot(void);
+static void GetGuid(uint32_t guid[4]);
+static void FillImage(uint8_t *image, uint32_t size, uint32_t seed);
+static void SetFooter(uint8_t *image);
+static uint16_t BuildDeltaSegment(const uint8_t *installed, const uint8_t *image,
+	uint32_t offset, uint16_t size, uint8_t *delta);
+static void PutValue(uint8_t **data, uint32_t value, uint16_t valueSize);
+static bool IsInAppArea(const HOST_FLASH_WRITE *write);
+static void Setup(const uint8_t *installed);
+static void StageImage(const uint8_t *installed, const uint8_t *image);
+
+
+//	the product info and bootloader interface
+static const BOOTLOADER_PRODUCT_INFO_STRUCT productInfo = { "DeltaTest", "ECCO", "1", "1.0", "1.0", "", "" };
+static const BOOTLOADER_INTERFACE_TABLE interfaceTable =
+{
+	NULL,
+	&productInfo,
+	APP_ADDRESS,
+	APP_SIZE,
+	SendCanFrame,
+	HostFlash_WriteWithErase,
+	Reboot,
+	GetGuid,
+	NULL,
+	STAGING_ADDRESS,
+	STAGING_SIZE,
+	MARKER_ADDRESS,
+};
+
+//	the installed and new images
+static uint8_t installedImage[APP_SIZE];
+static uint8_t newImage[APP_SIZE];
+
+//	the number of failed checks
+static int numFailures;
+
+
+/**
+  * @brief  Runs the tests.
+  * @param  None.
+  * @retval Returns 0 if all tests pass, else 1.
+  */
+int main(void)
+{
+	uint8_t delta[16], output[SEGMENT_SIZE];
+	uint8_t *d;
+	uint32_t numWrites, i;
+
+	//	build the installed image, and a new image with some blocks changed
+	FillImage(installedImage, APP_SIZE, 1);
+	SetFooter(installedImage);
+	memcpy(newImage, installedImage, APP_SIZE);
+	FillImage(&newImage[0x1000], 0x800, 2);
+	memset(&newImage[0x1000 + 0x800], 0, 0x3000);
+	SetFooter(newImage);
+
+	//	apply rejects a copy outside the installed image, a short insert and an unknown command
+	Setup(installedImage);
+	d = delta;
+	*d++ = DELTA_COMMAND_COPY;
+	PutValue(&d, APP_SIZE - 8, 4);
+	PutValue(&d, 16, 2);
+	CHECK(-1 == Delta_ApplySegment(delta, d - delta, output, sizeof(output)));
+	d = delta;
+	*d++ = DELTA_COMMAND_INSERT;
+	PutValue(&d, 4, 2);
+	*d++ = 0x55;
+	CHECK(-1 == Delta_ApplySegment(delta, d - delta, output, sizeof(output)));
+	delta[0] = 2;
+	CHECK(-1 == Delta_ApplySegment(delta, 1, output, sizeof(output)));
+
+	//	the new image is staged and installed in whole pages, clipped to the application area
+	Setup(installedImage);
+	Bootloader_VerifyApp(&interfaceTable);
+	CHECK(BOOTLOADER_VERIFIED_MARKER_KEY == *(uint32_t *)HostFlash_Pointer(MARKER_ADDRESS));
+	StageImage(installedImage, newImage);
+	CHECK(0 == memcmp(HostFlash_Pointer(STAGING_ADDRESS), newImage, APP_SIZE));
+	numWrites = HostFlash_NumWrites;
+	CHECK(BSC_OK == Delta_InstallStagedImage());
+	CHECK(0 == memcmp(HostFlash_Pointer(APP_ADDRESS), newImage, APP_SIZE));
+	CHECK(BOOTLOADER_VERIFIED_MARKER_KEY != *(uint32_t *)HostFlash_Pointer(MARKER_ADDRESS));
+	CHECK(MARKER_ADDRESS == HostFlash_Writes[numWrites].address);
+	for (i = numWrites + 1; i < HostFlash_NumWrites; ++i)
+		CHECK(IsInAppArea(&HostFlash_Writes[i]));
+	CHECK((HostFlash_NumWrites - numWrites - 1) == (((APP_ADDRESS + APP_SIZE + PAGE_WRITER_PAGE_SIZE - 1) / PAGE_WRITER_PAGE_SIZE)
+		- (APP_ADDRESS / PAGE_WRITER_PAGE_SIZE)));
+	CHECK(Bootloader_VerifyApp(&interfaceTable));
+	printf("install: %u page writes for %u bytes\n", (unsigned)(HostFlash_NumWrites - numWrites - 1), APP_SIZE);
+
+	//	a staged image with a bad CRC is not installed
+	Setup(installedImage);
+	StageImage(installedImage, newImage);
+	HostFlash_Pointer(STAGING_ADDRESS)[0x2000] ^= 1;
+	CHECK(BSC_VERIFY_ERROR == Delta_InstallStagedImage());
+	CHECK(0 == memcmp(HostFlash_Pointer(APP_ADDRESS), installedImage, APP_SIZE));
+
+	//	a failed page write is reported
+	Setup(installedImage);
+	StageImage(installedImage, newImage);
+	Bootloader_ClearVerifiedMarker(&interfaceTable);
+	HostFlash_FailNextWrite = true;
+	CHECK(BSC_FLASH_WRITE_ERROR == Delta_InstallStagedImage());
+
+	if (numFailures)
+	{
+		printf("delta_test: %d checks failed\n", numFailures);
+		return 1;
+	}
+	printf("delta_test: all checks passed\n");
+	return 0;
+}
+
+
+//	private methods.................................
+
+/**
+  * @brief  Counts and prints a failed check.
+  * @param  condition: The check condition.
+  * @param  text: The check text.
+  * @param  line: The check line number.
+  * @retval None.
+  */
+static void Check(bool condition, const char *text, int line)
+{
+	if (condition)
+		return;
+	++numFailures;
+	printf("line %d: check failed: %s\n", line, text);
+}
+
+/**
+  * @brief  Interface stubs, the test does not use the bus.
+  */
+static void SendCanFrame(ENET_CAN_FRAME *frame)
+{
+}
+static int Reboot(void)
+{
+	return 0;
+}
+static void GetGuid(uint32_t guid[4])
+{
+	memset(guid, 0, 16);
+}
+
+/**
+  * @brief  Fills an image with pseudo-random bytes.
+  * @param  image: A pointer to the image.
+  * @param  size: The number of bytes to fill.
+  * @param  seed: The random seed.
+  * @retval None.
+  */
+static void FillImage(uint8_t *image, uint32_t size, uint32_t seed)
+{
+	uint32_t i;
+	for (i = 0; i < size; ++i)
+	{
+		seed = (seed * 1103515245) + 12345;
+		image[i] = (uint8_t)(seed >> 16);
+	}
+}
+
+/**
+  * @brief  Sets the image footer and CRC32.
+  * @param  image: A pointer to the image.
+  * @retval None.
+  */
+static void SetFooter(uint8_t *image)
+{
+	ECCONET_FLASH_FILE_FOOTER footer;
+
+	memset(&footer, 0, sizeof(footer));
+	footer.codebaseKey = ECCONET_FLASH_FILE_FOOTER_KEY;
+	strncpy(footer.modelName, productInfo.modelName, sizeof(footer.modelName));
+	footer.appAddress = APP_ADDRESS;
+	memcpy(&image[APP_SIZE - sizeof(footer)], &footer, sizeof(footer));
+	footer.appCRC32 = Bootloader_ComputeCRC32(image, APP_SIZE - 4);
+	memcpy(&image[APP_SIZE - 4], &footer.appCRC32, 4);
+}
+
+/**
+  * @brief  Builds a delta segment, copying the blocks that match the installed image.
+  * @param  installed: A pointer to the installed image.
+  * @param  image: A pointer to the new image.
+  * @param  offset: The segment offset in the image.
+  * @param  size: The segment size.
+  * @param  delta: A pointer to a buffer to receive the delta segment.
+  * @retval The delta segment size.
+  */
+static uint16_t BuildDeltaSegment(const uint8_t *installed, const uint8_t *image,
+	uint32_t offset, uint16_t size, uint8_t *delta)
+{
+	uint8_t *d = delta;
+	uint16_t length;
+
+	while (size)
+	{
+		length = MIN(size, BLOCK_SIZE);
+		if (0 == memcmp(&installed[offset], &image[offset], length))
+		{
+			*d++ = DELTA_COMMAND_COPY;
+			PutValue(&d, offset, 4);
+			PutValue(&d, length, 2);
+		}
+		else
+		{
+			*d++ = DELTA_COMMAND_INSERT;
+			PutValue(&d, length, 2);
+			memcpy(d, &image[offset], length);
+			d += length;
+		}
+		offset += length;
+		size -= length;
+	}
+	return d - delta;
+}
+
+/**
+  * @brief  Puts a big-endian value in the delta and advances the delta pointer.
+  * @param  data: A pointer to the delta pointer.
+  * @param  value: The value.
+  * @param  valueSize: The value size.
+  * @retval None.
+  */
+static void PutValue(uint8_t **data, uint32_t value, uint16_t valueSize)
+{
+	while (valueSize--)
+		*(*data)++ = (uint8_t)(value >> (8 * valueSize));
+}
+
+/**
+  * @brief  Checks that a driver write is within the application area.
+  * @param  write: A pointer to the logged write.
+  * @retval True if the write is within the application area.
+  */
+static bool IsInAppArea(const HOST_FLASH_WRITE *write)
+{
+	return (write->address >= APP_ADDRESS) && (write->size <= APP_SIZE)
+		&& ((write->address - APP_ADDRESS) <= (APP_SIZE - write->size));
+}
+
+/**
+  * @brief  Resets the flash and bootloader, with the image installed.
+  * @param  installed: A pointer to the installed image.
+  * @retval None.
+  */
+static void Setup(const uint8_t *installed)
+{
+	if (0 != HostFlash_Reset(PAGE_WRITER_PAGE_SIZE))
+	{
+		printf("delta_test: cannot map the flash\n");
+		exit(1);
+	}
+	memcpy(HostFlash_Pointer(APP_ADDRESS), installed, APP_SIZE);
+	Bootloader_Reset(&interfaceTable, 0);
+}
+
+/**
+  * @brief  Stages the new image from delta segments, as the receiver does.
+  * @param  installed: A pointer to the installed image.
+  * @param  image: A pointer to the new image.
+  * @retval None.
+  */
+static void StageImage(const uint8_t *installed, const uint8_t *image)
+{
+	static uint8_t delta[SEGMENT_SIZE * 2], output[SEGMENT_SIZE];
+	uint32_t offset, errorAddress;
+	uint16_t size, deltaSize;
+	int32_t outputSize;
+
+	for (offset = 0; offset < APP_SIZE; offset += size)
+	{
+		size = MIN(APP_SIZE - offset, SEGMENT_SIZE);
+		deltaSize = BuildDeltaSegment(installed, image, offset, size, delta);
+		outputSize = Delta_ApplySegment(delta, deltaSize, output, sizeof(output));
+		CHECK(size == outputSize);
+		PageWriter_Write(STAGING_ADDRESS + offset, output, outputSize);
+	}
+	PageWriter_Flush();
+	CHECK(!PageWriter_GetWriteError(&errorAddress));
+}
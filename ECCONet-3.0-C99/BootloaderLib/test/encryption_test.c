@@ -0,0 +1,169 @@
+/**
+  ******************************************************************************
+  * @file    		encryption_test.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test and benchmark of the word-at-a-time encryption.
+	*
+	*							Built and run on the host, from this directory:
+	*							gcc -std=c99 -O2 -I.. -I../.. -o /tmp/encryption_test
+	*								encryption_test.c ../bootloader.c ../receiver.c ../transmitter.c
+	*								../encryption.c ../can_address.c ../decompress.c ../delta.c ../page_writer.c
+	*							/tmp/encryption_test
+	*
+	*							The output is compared with the original byte-at-a-time method
+	*							for random keys, sizes and data alignments.
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ecconet.h"
+#include "bootloader_interface.h"
+#include "encryption.h"
+
+
+//	the largest data size compared, and the number of random keys
+#define MAX_DATA_SIZE     600
+#define NUM_KEYS          200
+
+//	the benchmark number of bytes encrypted for each message size
+#define BENCHMARK_BYTES   (64 * 1024 * 1024)
+
+
+//	private methods
+static void ReferenceEncryptWithKey(uint8_t *data, int32_t dataSize, const uint32_t key[4]);
+static uint32_t Random(void);
+static double Benchmark(void (*encrypt)(uint8_t *, int32_t, const uint32_t [4]), int32_t size, const uint32_t key[4]);
+
+
+//	the random seed
+static uint32_t seed = 1;
+
+//	the test data
+static uint8_t data[MAX_DATA_SIZE + 4], expected[MAX_DATA_SIZE + 4], original[MAX_DATA_SIZE + 4];
+static const int32_t benchmarkSizes[] = { 16, 64, 256, 600 };
+
+
+/**
+  * @brief  Runs the test and benchmark.
+  * @param  None.
+  * @retval Returns 0 if the test passes, else 1.
+  */
+int main(void)
+{
+	uint32_t key[4];
+	int32_t size;
+	uint16_t k, i, offset;
+	int numFailures = 0, numCompared = 0;
+	double referenceTime, time;
+	uint8_t b;
+
+	//	compare with the reference for random keys, all sizes and all word alignments
+	for (k = 0; k < NUM_KEYS; ++k)
+	{
+		for (i = 0; i < 4; ++i)
+			key[i] = Random();
+		for (i = 0; i < sizeof(original); ++i)
+			original[i] = (uint8_t)Random();
+		for (offset = 0; offset < 4; ++offset)
+		{
+			for (size = 0; size <= MAX_DATA_SIZE; ++size)
+			{
+				memcpy(expected, original, sizeof(original));
+				memcpy(data, original, sizeof(original));
+				ReferenceEncryptWithKey(&expected[offset], size, key);
+				Encryption_EncryptWithKey(&data[offset], size, key);
+				++numCompared;
+				if (0 != memcmp(data, expected, sizeof(data)))
+				{
+					if (++numFailures <= 10)
+						printf("mismatch: key %08X %08X %08X %08X, offset %u, size %d\n",
+							(unsigned)key[0], (unsigned)key[1], (unsigned)key[2], (unsigned)key[3], offset, (int)size);
+				}
+
+				//	encrypting again restores the data
+				Encryption_EncryptWithKey(&data[offset], size, key);
+				if (0 != memcmp(data, original, sizeof(data)))
+					++numFailures;
+			}
+		}
+	}
+	printf("compared %d encryptions with the byte-wise method, %d failures\n", numCompared, numFailures);
+
+	//	benchmark both methods for a range of message sizes
+	for (b = 0; b < (sizeof(benchmarkSizes) / sizeof(benchmarkSizes[0])); ++b)
+	{
+		referenceTime = Benchmark(ReferenceEncryptWithKey, benchmarkSizes[b], key);
+		time = Benchmark(Encryption_EncryptWithKey, benchmarkSizes[b], key);
+		printf("%3d bytes: byte-wise %7.1f MB/s, word-at-a-time %7.1f MB/s, %.1fx\n", (int)benchmarkSizes[b],
+			BENCHMARK_BYTES / referenceTime / 1e6, BENCHMARK_BYTES / time / 1e6, referenceTime / time);
+	}
+
+	return numFailures ? 1 : 0;
+}
+
+
+//	private methods.................................
+
+/**
+  * @brief  The original byte-at-a-time method, used as the reference.
+  * @param  data: A pointer to the data to encrypt.
+  * @param  dataSize: The size of the data to encrypt in bytes.
+  * @param  key: An array of four uint32_t that are the 128-bit key.
+  * @retval None.
+  */
+static void ReferenceEncryptWithKey(uint8_t *data, int32_t dataSize, const uint32_t key[4])
+{
+	uint16_t i;
+	uint8_t convolutedKeys[16];
+
+	//	get convoluted keys
+	for (i = 0; i < 16; ++i)
+		convolutedKeys[i] = (key[i >> 2] ^ 0x90208f7f) >> ((i >> 2) << 3);
+
+	//	for all data bytes
+	for (i = 0; i < dataSize; ++i)
+		*data++ ^= convolutedKeys[(i ^ (convolutedKeys[(i >> 4) & 0x0f])) & 0x0f];
+}
+
+/**
+  * @brief  Gets a pseudo-random value.
+  * @param  None.
+  * @retval A pseudo-random value.
+  */
+static uint32_t Random(void)
+{
+	seed ^= seed << 13;
+	seed ^= seed >> 17;
+	seed ^= seed << 5;
+	return seed;
+}
+
+/**
+  * @brief  Times an encryption method.
+  * @param  encrypt: The encryption method.
+  * @param  size: The message size.
+  * @param  key: The key.
+  * @retval The time in seconds to encrypt BENCHMARK_BYTES.
+  */
+static double Benchmark(void (*encrypt)(uint8_t *, int32_t, const uint32_t [4]), int32_t size, const uint32_t key[4])
+{
+	clock_t start;
+	uint32_t pass;
+
+	start = clock();
+	for (pass = 0; pass < (BENCHMARK_BYTES / size); ++pass)
+		encrypt(data, size, key);
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    		host_compress.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test support: compresses flash write segments for Decompress_Segment.
+	*
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include "ecconet.h"
+#include "decompress.h"
+#include "host_compress.h"
+
+
+/**
+  * @brief  Compresses the start of the data into one segment, in the format of decompress.h.
+	*					Compression stops when the decompressed segment would exceed the output size,
+	*					or the compressed segment would exceed the compressed size.
+	* @param  input: A pointer to the data.
+	* @param  inputSize: The data size.
+	* @param  outputSize: The largest decompressed segment size.
+	* @param  compressed: A pointer to a buffer to receive the compressed segment.
+	* @param  compressedSize: The compressed segment buffer size.
+	* @param  inputUsed: A pointer to a value that receives the number of data bytes compressed.
+  * @retval Returns the compressed segment size.
+  */
+uint16_t HostCompress_Segment(const uint8_t *input, uint32_t inputSize, uint16_t outputSize,
+	uint8_t *compressed, uint16_t compressedSize, uint16_t *inputUsed)
+{
+	uint16_t index, maxLength, length, bestLength, bestOffset, offset, itemSize;
+	uint16_t compressedIndex, controlIndex;
+	uint8_t bit;
+
+	//	the decompressed segment is the start of the input, up to the output size
+	inputSize = MIN(inputSize, outputSize);
+	index = compressedIndex = controlIndex = 0;
+	bit = 8;
+	while (index < inputSize)
+	{
+		//	find the longest match in the segment so far, the nearest if tied
+		maxLength = MIN(inputSize - index, HOST_COMPRESS_MAX_MATCH_LENGTH);
+		bestLength = bestOffset = 0;
+		for (offset = 1; offset <= index; ++offset)
+		{
+			for (length = 0; (length < maxLength) && (input[index + length] == input[index - offset + length]); ++length)
+				;
+			if (length > bestLength)
+			{
+				bestLength = length;
+				bestOffset = offset;
+			}
+		}
+		itemSize = (bestLength >= DECOMPRESS_MIN_MATCH_LENGTH) ? 2 : 1;
+
+		//	if the item and any new control byte do not fit, then done
+		if ((compressedIndex + itemSize + ((8 == bit) ? 1 : 0)) > compressedSize)
+			break;
+
+		//	start a new group
+		if (8 == bit)
+		{
+			controlIndex = compressedIndex++;
+			compressed[controlIndex] = 0;
+			bit = 0;
+		}
+
+		//	add the match or literal
+		if (2 == itemSize)
+		{
+			compressed[controlIndex] |= (1 << bit);
+			compressed[compressedIndex++] = (uint8_t)((bestOffset - 1) >> 4);
+			compressed[compressedIndex++] = (uint8_t)(((bestOffset - 1) << 4) | (bestLength - DECOMPRESS_MIN_MATCH_LENGTH));
+			index += bestLength;
+		}
+		else
+		{
+			compressed[compressedIndex++] = input[index++];
+		}
+		++bit;
+	}
+	*inputUsed = index;
+	return compressedIndex;
+}
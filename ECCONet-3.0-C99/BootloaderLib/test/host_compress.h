@@ -0,0 +1,49 @@
+/**
+  ******************************************************************************
+  * @file    		host_compress.h
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test support: compresses flash write segments for Decompress_Segment.
+	*
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __HOST_COMPRESS_H
+#define __HOST_COMPRESS_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//	the longest match
+#define HOST_COMPRESS_MAX_MATCH_LENGTH  18
+
+
+/**
+  * @brief  Compresses the start of the data into one segment, in the format of decompress.h.
+	*					Compression stops when the decompressed segment would exceed the output size,
+	*					or the compressed segment would exceed the compressed size.
+	* @param  input: A pointer to the data.
+	* @param  inputSize: The data size.
+	* @param  outputSize: The largest decompressed segment size.
+	* @param  compressed: A pointer to a buffer to receive the compressed segment.
+	* @param  compressedSize: The compressed segment buffer size.
+	* @param  inputUsed: A pointer to a value that receives the number of data bytes compressed.
+  * @retval Returns the compressed segment size.
+  */
+extern uint16_t HostCompress_Segment(const uint8_t *input, uint32_t inputSize, uint16_t outputSize,
+	uint8_t *compressed, uint16_t compressedSize, uint16_t *inputUsed);
+
+
+#endif  //  __HOST_COMPRESS_H
@@ -0,0 +1,105 @@
+/**
+  ******************************************************************************
+  * @file    		host_flash.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test support: a fake memory-mapped flash with an erase-on-write driver.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#define _DEFAULT_SOURCE
+#include <string.h>
+#include <sys/mman.h>
+#include "host_flash.h"
+
+
+//	the driver writes since the last reset, and whether the next write fails
+HOST_FLASH_WRITE HostFlash_Writes[HOST_FLASH_MAX_LOGGED_WRITES];
+uint32_t HostFlash_NumWrites;
+bool HostFlash_FailNextWrite;
+
+//	the flash and its page size
+static uint8_t *flash;
+static uint32_t flashPageSize;
+
+
+/**
+  * @brief  Maps the fake flash, if not mapped, and erases it.
+  * @param  pageSize: The flash page size, a power of two.
+  * @retval Returns 0 on success, else -1.
+  */
+int HostFlash_Reset(uint32_t pageSize)
+{
+	void *map;
+	
+	if (NULL == flash)
+	{
+		map = mmap((void *)(uintptr_t)HOST_FLASH_ADDRESS, HOST_FLASH_SIZE, PROT_READ | PROT_WRITE,
+			MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0);
+		if (MAP_FAILED == map)
+			return -1;
+		flash = (uint8_t *)map;
+	}
+	memset(flash, HOST_FLASH_ERASED, HOST_FLASH_SIZE);
+	flashPageSize = pageSize;
+	HostFlash_NumWrites = 0;
+	HostFlash_FailNextWrite = false;
+	return 0;
+}
+
+/**
+  * @brief  A flash write method like an erase-on-write product driver.
+	*					Each page that the write touches is erased, and then the data is written,
+	*					so page bytes outside the write are left erased.
+  * @param  address: The starting location in flash address space.
+  * @param  data: A pointer to the data to be written.
+  * @param  dataSize: The number of bytes to be written.
+  * @retval Returns true on success.
+  */
+bool HostFlash_WriteWithErase(uint32_t address, void *data, uint32_t dataSize)
+{
+	uint32_t page, endPage;
+	
+	//	log and validate the write
+	if (HostFlash_NumWrites < HOST_FLASH_MAX_LOGGED_WRITES)
+	{
+		HostFlash_Writes[HostFlash_NumWrites].address = address;
+		HostFlash_Writes[HostFlash_NumWrites].size = dataSize;
+	}
+	++HostFlash_NumWrites;
+	if ((address < HOST_FLASH_ADDRESS) || (0 == dataSize)
+		|| ((address - HOST_FLASH_ADDRESS + dataSize) > HOST_FLASH_SIZE))
+		return false;
+	if (HostFlash_FailNextWrite)
+	{
+		HostFlash_FailNextWrite = false;
+		return false;
+	}
+	
+	//	erase the pages, then write the data
+	page = address & ~(flashPageSize - 1);
+	endPage = (address + dataSize + flashPageSize - 1) & ~(flashPageSize - 1);
+	memset(HostFlash_Pointer(page), HOST_FLASH_ERASED, endPage - page);
+	memcpy(HostFlash_Pointer(address), data, dataSize);
+	return true;
+}
+
+/**
+  * @brief  Gets a pointer to a flash address.
+  * @param  address: The flash address.
+  * @retval A pointer to the address.
+  */
+uint8_t *HostFlash_Pointer(uint32_t address)
+{
+	return (uint8_t *)(uintptr_t)address;
+}
@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    		host_flash.h
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test support: a fake memory-mapped flash with an erase-on-write driver.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __HOST_FLASH_H
+#define __HOST_FLASH_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+
+//	the fake flash is mapped at a fixed address below 4 GB,
+//	since the bootloader library uses 32-bit flash addresses as pointers
+#define HOST_FLASH_ADDRESS  0x10000000
+#define HOST_FLASH_SIZE     (512 * 1024)
+
+//	the value of erased flash
+#define HOST_FLASH_ERASED   0xFF
+
+//	the number of driver writes that are logged
+#define HOST_FLASH_MAX_LOGGED_WRITES  1024
+
+
+/**
+  * @brief  A logged driver write.
+  */
+typedef struct
+{
+	uint32_t address;
+	uint32_t size;
+	
+} HOST_FLASH_WRITE;
+
+
+//	the driver writes since the last reset, and whether the next write fails
+extern HOST_FLASH_WRITE HostFlash_Writes[HOST_FLASH_MAX_LOGGED_WRITES];
+extern uint32_t HostFlash_NumWrites;
+extern bool HostFlash_FailNextWrite;
+
+
+/**
+  * @brief  Maps the fake flash, if not mapped, and erases it.
+  * @param  pageSize: The flash page size, a power of two.
+  * @retval Returns 0 on success, else -1.
+  */
+extern int HostFlash_Reset(uint32_t pageSize);
+
+/**
+  * @brief  A flash write method like an erase-on-write product driver.
+	*					Each page that the write touches is erased, and then the data is written,
+	*					so page bytes outside the write are left erased.
+  * @param  address: The starting location in flash address space.
+  * @param  data: A pointer to the data to be written.
+  * @param  dataSize: The number of bytes to be written.
+  * @retval Returns true on success.
+  */
+extern bool HostFlash_WriteWithErase(uint32_t address, void *data, uint32_t dataSize);
+
+/**
+  * @brief  Gets a pointer to a flash address.
+  * @param  address: The flash address.
+  * @retval A pointer to the address.
+  */
+extern uint8_t *HostFlash_Pointer(uint32_t address);
+
+
+#endif  //  __HOST_FLASH_H
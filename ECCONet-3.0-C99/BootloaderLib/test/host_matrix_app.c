@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    		host_matrix_app.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test support: the application firmware CRC check of the Matrix library.
+	*
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "matrix.h"
+#include "matrix_firmware_crc.h"
+#include "host_matrix_app.h"
+
+
+/**
+  * @brief  The Matrix data object, of which the firmware CRC uses the app interface.
+  */
+MATRIX_OBJECT Matrix;
+
+
+//	the app interface
+static MATRIX_INTERFACE_TABLE interfaceTable;
+
+
+/**
+  * @brief  Runs the Matrix library application firmware CRC over an image until it is cached.
+  * @param  baseAddress: The image base address.
+  * @param  size: The image size.
+  * @param  crcError: The method called if the image does not match its footer CRC32, or null.
+  * @retval The number of library clocks taken.
+  */
+uint32_t HostMatrixApp_CheckFirmware(uint32_t baseAddress, uint32_t size, void (*crcError)(void))
+{
+	uint32_t numClocks = 0;
+
+	//	set the app interface, and compute the CRC a slice per clock
+	memset(&interfaceTable, 0, sizeof(interfaceTable));
+	interfaceTable.appFirmwareImage.baseAddress = baseAddress;
+	interfaceTable.appFirmwareImage.size = size;
+	interfaceTable.appFirmwareCrcError = crcError;
+	Matrix.appInterface = &interfaceTable;
+	MatrixFirmwareCrc_Reset();
+	while ((numClocks * MATRIX_FIRMWARE_CRC_SLICE_SIZE) < size)
+	{
+		MatrixFirmwareCrc_Clock();
+		++numClocks;
+	}
+	return numClocks;
+}
+
+/**
+  * @brief  Sends a token to the bus, which the test does not use.
+  * @param  token: The token.
+  * @retval Returns 0.
+  */
+int Matrix_PrivateSendCanToken(TOKEN *token)
+{
+	return 0;
+}
@@ -0,0 +1,40 @@
+/**
+  ******************************************************************************
+  * @file    		host_matrix_app.h
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test support: the application firmware CRC check of the Matrix library.
+	*
+	*							The Matrix and bootloader headers cannot be included together,
+	*							so the application side is kept in its own file.
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __HOST_MATRIX_APP_H
+#define __HOST_MATRIX_APP_H
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+/**
+  * @brief  Runs the Matrix library application firmware CRC over an image until it is cached.
+  * @param  baseAddress: The image base address.
+  * @param  size: The image size.
+  * @param  crcError: The method called if the image does not match its footer CRC32, or null.
+  * @retval The number of library clocks taken.
+  */
+extern uint32_t HostMatrixApp_CheckFirmware(uint32_t baseAddress, uint32_t size, void (*crcError)(void));
+
+
+#endif  //  __HOST_MATRIX_APP_H
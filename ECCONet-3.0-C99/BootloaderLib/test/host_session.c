@@ -0,0 +1,439 @@
+/**
+  ******************************************************************************
+  * @file    		host_session.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test support: a simulated firmware update session.
+	*
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ecconet.h"
+#include "bootloader_interface.h"
+#include "bootloader.h"
+#include "encryption.h"
+#include "receiver.h"
+#include "page_writer.h"
+#include "host_compress.h"
+#include "host_session.h"
+
+
+//	the number of host frames that can be on the bus
+#define QUEUE_SIZE  64
+
+
+//	private methods
+static void BuildSegments(void);
+static void SendSegment(uint16_t segment, uint32_t time);
+static void SendReboot(uint32_t time);
+static void SendMessage(uint8_t *message, uint16_t messageSize, uint32_t time);
+static void DeliverFrames(void);
+static void ReceiveReply(uint8_t status, uint32_t time);
+static void PutValue(uint8_t **data, uint32_t value, uint16_t valueSize);
+static void SendCanFrame(ENET_CAN_FRAME *frame);
+static bool FlashWrite(uint32_t address, void *data, uint32_t dataSize);
+static int Reboot(void);
+static void GetGuid(uint32_t guid[4]);
+
+
+/**
+  * @brief  A host frame on the bus, and the time that it is received.
+  */
+typedef struct
+{
+	uint32_t time;
+	ENET_CAN_FRAME frame;
+
+} QUEUED_FRAME;
+
+/**
+  * @brief  The session data object.
+  */
+static struct
+{
+	//	the configuration and result
+	const HOST_SESSION_CONFIG *config;
+	HOST_SESSION_RESULT *result;
+
+	//	the segment locations, data size fields and data
+	uint32_t locations[HOST_SESSION_MAX_SEGMENTS];
+	uint16_t dataSizes[HOST_SESSION_MAX_SEGMENTS];
+	uint16_t payloadSizes[HOST_SESSION_MAX_SEGMENTS];
+	uint8_t payloads[HOST_SESSION_MAX_SEGMENTS][HOST_SESSION_SEGMENT_SIZE];
+	uint16_t numSegments;
+
+	//	the host frames on the bus
+	QUEUED_FRAME queue[QUEUE_SIZE];
+	uint16_t queueHead, queueTail;
+
+	//	the processor time, and the time the bus is free
+	uint32_t cpuTime;
+	uint32_t busTime;
+
+	//	the last segment sent, and whether the reboot request was sent
+	uint16_t segment;
+	bool isRebootSent;
+
+	//	a reply held until the flash write returns
+	bool isReplyPending;
+	uint8_t replyStatus;
+
+	//	the session is done
+	bool isDone;
+
+} Session;
+
+//	the device address and product info, and the bootloader interface
+static const BOOTLOADER_CAN_ADDRESS_STRUCT canAddress = { HOST_SESSION_DEVICE_ADDRESS, 1 };
+static const BOOTLOADER_PRODUCT_INFO_STRUCT productInfo = { "SessionTest", "ECCO", "1", "1.0", "1.0", "", "" };
+static const BOOTLOADER_INTERFACE_TABLE interfaceTable =
+{
+	&canAddress,
+	&productInfo,
+	HOST_SESSION_APP_ADDRESS,
+	HOST_SESSION_APP_SIZE,
+	SendCanFrame,
+	FlashWrite,
+	Reboot,
+	GetGuid,
+	NULL,
+	0,
+	0,
+	0,
+};
+
+
+/**
+  * @brief  Runs a simulated update session into an erased application area.
+  * @param  config: A pointer to the session configuration.
+  * @param  result: A pointer to a struct to receive the session result.
+  * @retval None.
+  */
+void HostSession_Run(const HOST_SESSION_CONFIG *config, HOST_SESSION_RESULT *result)
+{
+	//	reset the flash, bootloader and session
+	memset(result, 0, sizeof(HOST_SESSION_RESULT));
+	if (0 != HostFlash_Reset(PAGE_WRITER_PAGE_SIZE))
+		return;
+	Bootloader_Reset(&interfaceTable, 0);
+	Session.config = config;
+	Session.result = result;
+	Session.queueHead = Session.queueTail = 0;
+	Session.cpuTime = Session.busTime = 0;
+	Session.isRebootSent = false;
+	Session.isReplyPending = false;
+	Session.isDone = false;
+	BuildSegments();
+	result->numSegments = Session.numSegments;
+
+	//	send the first segment, and clock the bootloader until the device reboots
+	SendSegment(0, 0);
+	while (!Session.isDone && (Session.cpuTime < (600 * 1000000UL)))
+	{
+		DeliverFrames();
+		Bootloader_Clock(Session.cpuTime / 1000);
+
+		//	if the host held the reply, then receive it now that the write has returned
+		if (Session.isReplyPending)
+		{
+			Session.isReplyPending = false;
+			Session.busTime = MAX(Session.busTime, Session.cpuTime) + HOST_SESSION_FRAME_TIME_US;
+			ReceiveReply(Session.replyStatus, Session.busTime);
+		}
+		Session.cpuTime += HOST_SESSION_CLOCK_TIME_US;
+	}
+	result->timeUs = Session.cpuTime;
+}
+
+/**
+  * @brief  Prints a session result.
+  * @param  name: The session name.
+  * @param  result: A pointer to the session result.
+  * @retval None.
+  */
+void HostSession_Print(const char *name, const HOST_SESSION_RESULT *result)
+{
+	printf("%-24s %8.3f s, %4u segments (%u sent), %6u frames, %7u bytes on the wire, %4u flash writes, %u error replies%s\n",
+		name, result->timeUs / 1e6, (unsigned)result->numSegments, (unsigned)result->numSegmentsSent,
+		(unsigned)result->numFrames, (unsigned)result->numWireBytes, (unsigned)result->numFlashWrites,
+		(unsigned)result->numErrorReplies, result->isRebooted ? "" : ", not rebooted");
+}
+
+
+//	private methods.................................
+
+/**
+  * @brief  Splits the image into segments, compressing each one if that makes it smaller.
+  * @param  None.
+  * @retval None.
+  */
+static void BuildSegments(void)
+{
+	uint32_t offset;
+	uint16_t size, compressedSize;
+	uint8_t *payload;
+
+	Session.numSegments = 0;
+	for (offset = 0; (offset < Session.config->imageSize) && (Session.numSegments < HOST_SESSION_MAX_SEGMENTS);
+		offset += size)
+	{
+		Session.locations[Session.numSegments] = HOST_SESSION_APP_ADDRESS + offset;
+		payload = Session.payloads[Session.numSegments];
+
+		//	if compressed, then compress up to a decompressed segment into the segment data
+		compressedSize = 0;
+		size = 0;
+		if (Session.config->isCompressed)
+			compressedSize = HostCompress_Segment(&Session.config->image[offset], Session.config->imageSize - offset,
+				DECOMPRESS_OUTPUT_SIZE, payload, HOST_SESSION_SEGMENT_SIZE, &size);
+
+		//	if the data compressed, then send it compressed, else send it raw
+		if (compressedSize && (compressedSize < size))
+		{
+			Session.dataSizes[Session.numSegments] = compressedSize | ENET_COMPRESSED_DATA_SIZE_FLAG;
+			Session.payloadSizes[Session.numSegments] = compressedSize;
+		}
+		else
+		{
+			size = MIN(Session.config->imageSize - offset, HOST_SESSION_SEGMENT_SIZE);
+			Session.dataSizes[Session.numSegments] = size;
+			Session.payloadSizes[Session.numSegments] = size;
+			memcpy(payload, &Session.config->image[offset], size);
+		}
+		++Session.numSegments;
+	}
+}
+
+/**
+  * @brief  Sends a fixed-segment write.
+  * @param  segment: The segment index.
+  * @param  time: The time the host sends the segment.
+  * @retval None.
+  */
+static void SendSegment(uint16_t segment, uint32_t time)
+{
+	uint8_t message[RECEIVER_BUFFER_SIZE], *m = message;
+	uint16_t messageSize;
+
+	//	build the segment message
+	*m++ = 0;
+	PutValue(&m, KeyRequestFileWriteFixedSegment, 2);
+	PutValue(&m, Encryption_GetAccessCode(), 4);
+	memset(m, 0, 31);
+	strncpy((char *)m, productInfo.modelName, 31);
+	m += 31;
+	PutValue(&m, Session.locations[segment], 4);
+	PutValue(&m, Session.dataSizes[segment], 2);
+	memcpy(m, Session.payloads[segment], Session.payloadSizes[segment]);
+	m += Session.payloadSizes[segment];
+
+	//	encrypt the inner data, and add the checksum
+	messageSize = (m - message) + 2;
+	Encryption_Encrypt(&message[3], messageSize - (1 + 2 + 2));
+	PutValue(&m, Encryption_ComputeCRC16(message, messageSize - 2), 2);
+
+	Session.segment = segment;
+	++Session.result->numSegmentsSent;
+	SendMessage(message, messageSize, time);
+}
+
+/**
+  * @brief  Sends the reboot request.
+  * @param  time: The time the host sends the request.
+  * @retval None.
+  */
+static void SendReboot(uint32_t time)
+{
+	uint8_t message[8], *m = message;
+
+	*m++ = 0;
+	PutValue(&m, KeyRequestSystemReboot, 2);
+	PutValue(&m, Encryption_GetAccessCode() ^ TOKEN_VALUE_SYSTEM_REBOOT, 4);
+	Session.isRebootSent = true;
+	SendMessage(message, m - message, time);
+}
+
+/**
+  * @brief  Puts the frames of a message on the bus.
+  * @param  message: A pointer to the message.
+  * @param  messageSize: The message size.
+  * @param  time: The time the host sends the message.
+  * @retval None.
+  */
+static void SendMessage(uint8_t *message, uint16_t messageSize, uint32_t time)
+{
+	QUEUED_FRAME *queued;
+	uint16_t size;
+	bool isMultiFrame = (messageSize > 8);
+
+	Session.busTime = MAX(Session.busTime, time);
+	Session.result->numWireBytes += messageSize;
+	while (messageSize)
+	{
+		size = MIN(messageSize, 8);
+		messageSize -= size;
+		Session.busTime += HOST_SESSION_FRAME_TIME_US;
+		++Session.result->numFrames;
+
+		queued = &Session.queue[Session.queueHead];
+		Session.queueHead = (Session.queueHead + 1) % QUEUE_SIZE;
+		memset(queued, 0, sizeof(QUEUED_FRAME));
+		queued->time = Session.busTime;
+		queued->frame.idBits.destinationAddress = HOST_SESSION_DEVICE_ADDRESS;
+		queued->frame.idBits.sourceAddress = HOST_SESSION_HOST_ADDRESS;
+		queued->frame.idBits.frameType = !isMultiFrame ? ENET_MESSAGE_FRAME_TYPE_SINGLE :
+			(messageSize ? ENET_MESSAGE_FRAME_TYPE_BODY : ENET_MESSAGE_FRAME_TYPE_LAST);
+		queued->frame.dataSize = size;
+		memcpy(queued->frame.data, message, size);
+		message += size;
+	}
+}
+
+/**
+  * @brief  Receives the host frames that are on the bus by the processor time,
+	*					as the CAN receive interrupt does.
+  * @param  None.
+  * @retval None.
+  */
+static void DeliverFrames(void)
+{
+	while ((Session.queueTail != Session.queueHead)
+		&& (Session.queue[Session.queueTail].time <= Session.cpuTime))
+	{
+		Bootloader_ReceiveCanFrame(&Session.queue[Session.queueTail].frame);
+		Session.queueTail = (Session.queueTail + 1) % QUEUE_SIZE;
+	}
+}
+
+/**
+  * @brief  The host receives a fixed-segment write reply, and sends the next message.
+  * @param  status: The reply status.
+  * @param  time: The time the reply is received.
+  * @retval None.
+  */
+static void ReceiveReply(uint8_t status, uint32_t time)
+{
+	//	if written, then send the next segment, or the reboot request after the last segment
+	if (BSC_OK == status)
+	{
+		if ((Session.segment + 1) < Session.numSegments)
+			SendSegment(Session.segment + 1, time);
+		else
+			SendReboot(time);
+	}
+
+	//	else if a page failed to program, then restart at the segment before the one refused,
+	//	which holds the failed page, or resend the last segment if the reboot was refused
+	else if ((BSC_FLASH_WRITE_ERROR == status)
+		&& (++Session.result->numErrorReplies < HOST_SESSION_MAX_ERROR_REPLIES))
+	{
+		if (Session.isRebootSent)
+		{
+			Session.isRebootSent = false;
+			SendSegment(Session.numSegments - 1, time);
+		}
+		else
+		{
+			SendSegment(Session.segment ? (Session.segment - 1) : 0, time);
+		}
+	}
+
+	//	else give up
+	else
+	{
+		Session.isDone = true;
+	}
+}
+
+/**
+  * @brief  Puts a big-endian value in a message and advances the message pointer.
+  * @param  data: A pointer to the message pointer.
+  * @param  value: The value.
+  * @param  valueSize: The value size.
+  * @retval None.
+  */
+static void PutValue(uint8_t **data, uint32_t value, uint16_t valueSize)
+{
+	while (valueSize--)
+		*(*data)++ = (uint8_t)(value >> (8 * valueSize));
+}
+
+/**
+  * @brief  The device sends a frame, and the host receives write replies.
+  * @param  frame: A pointer to the frame.
+  * @retval None.
+  */
+static void SendCanFrame(ENET_CAN_FRAME *frame)
+{
+	uint16_t key;
+
+	//	if not a write reply to the host, then ignore it
+	key = ((uint16_t)frame->data[1] << 8) | frame->data[2];
+	if ((HOST_SESSION_HOST_ADDRESS != frame->idBits.destinationAddress)
+		|| (ENET_MESSAGE_FRAME_TYPE_SINGLE != frame->idBits.frameType)
+		|| (KeyResponseFileWriteFixedSegment != key))
+		return;
+
+	//	hold the reply until the write returns, or receive it now
+	if (Session.config->isReplyAfterWrite)
+	{
+		Session.isReplyPending = true;
+		Session.replyStatus = frame->data[3];
+	}
+	else
+	{
+		Session.busTime = MAX(Session.busTime, Session.cpuTime) + HOST_SESSION_FRAME_TIME_US;
+		ReceiveReply(frame->data[3], Session.busTime);
+	}
+}
+
+/**
+  * @brief  The device flash write, which takes processor time while frames are received.
+  * @param  address: The starting location in flash address space.
+  * @param  data: A pointer to the data to be written.
+  * @param  dataSize: The number of bytes to be written.
+  * @retval Returns true on success.
+  */
+static bool FlashWrite(uint32_t address, void *data, uint32_t dataSize)
+{
+	Session.cpuTime += HOST_SESSION_PAGE_WRITE_TIME_US;
+	DeliverFrames();
+	if (++Session.result->numFlashWrites == Session.config->failWriteNumber)
+		return false;
+	return HostFlash_WriteWithErase(address, data, dataSize);
+}
+
+/**
+  * @brief  The device reboots into the new image, which ends the session.
+  * @param  None.
+  * @retval An int, but not used.
+  */
+static int Reboot(void)
+{
+	Session.result->isRebooted = true;
+	Session.isDone = true;
+	return 0;
+}
+
+/**
+  * @brief  Gets the device guid.
+  * @param  guid: An array of four values to receive the guid.
+  * @retval None.
+  */
+static void GetGuid(uint32_t guid[4])
+{
+	guid[0] = 0x01234567;
+	guid[1] = 0x89ABCDEF;
+	guid[2] = 0x13579BDF;
+	guid[3] = 0x2468ACE0;
+}
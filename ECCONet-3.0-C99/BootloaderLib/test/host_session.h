@@ -0,0 +1,121 @@
+/**
+  ******************************************************************************
+  * @file    		host_session.h
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test support: a simulated firmware update session.
+	*
+	*							A simulated host sends an image to the bootloader as fixed-segment
+	*							writes, one segment at a time, waiting for each reply.  Frames take
+	*							bus time, and flash writes take processor time, during which frames
+	*							are still received as they would be by the CAN receive interrupt.
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __HOST_SESSION_H
+#define __HOST_SESSION_H
+
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "host_flash.h"
+
+
+//	the host and device CAN addresses
+#define HOST_SESSION_HOST_ADDRESS       1
+#define HOST_SESSION_DEVICE_ADDRESS     0x40
+
+//	the application area
+#define HOST_SESSION_APP_ADDRESS        (HOST_FLASH_ADDRESS + 0x8000)
+#define HOST_SESSION_APP_SIZE           0x40000
+
+//	the largest number of segments, and the raw data size of a segment,
+//	which is the receiver buffer size less the segment header and checksum
+#define HOST_SESSION_MAX_SEGMENTS       2048
+#define HOST_SESSION_SEGMENT_SIZE       256
+
+//	the time of an 8-byte extended CAN frame at 250 kbit/s with bit stuffing,
+//	the time to erase and program a flash page, and the time of a bootloader clock
+#define HOST_SESSION_FRAME_TIME_US      560
+#define HOST_SESSION_PAGE_WRITE_TIME_US 2500
+#define HOST_SESSION_CLOCK_TIME_US      100
+
+//	the host gives up after this many write error replies
+#define HOST_SESSION_MAX_ERROR_REPLIES  8
+
+
+/**
+  * @brief  The session configuration.
+  */
+typedef struct
+{
+	//	the image to send
+	const uint8_t *image;
+	uint32_t imageSize;
+
+	//	the segments are compressed
+	bool isCompressed;
+
+	//	the host holds each reply until the flash write returns,
+	//	as if the bootloader replied after writing flash
+	bool isReplyAfterWrite;
+
+	//	the number of the flash write that fails, or zero
+	uint32_t failWriteNumber;
+
+} HOST_SESSION_CONFIG;
+
+/**
+  * @brief  The session result.
+  */
+typedef struct
+{
+	//	the device rebooted into the new image
+	bool isRebooted;
+
+	//	the simulated update time
+	uint32_t timeUs;
+
+	//	the number of segments, and the number of segments sent including resends
+	uint32_t numSegments;
+	uint32_t numSegmentsSent;
+
+	//	the number of host frames, and the number of message bytes they carry
+	uint32_t numFrames;
+	uint32_t numWireBytes;
+
+	//	the number of flash writes, and of write error replies
+	uint32_t numFlashWrites;
+	uint32_t numErrorReplies;
+
+} HOST_SESSION_RESULT;
+
+
+/**
+  * @brief  Runs a simulated update session into an erased application area.
+  * @param  config: A pointer to the session configuration.
+  * @param  result: A pointer to a struct to receive the session result.
+  * @retval None.
+  */
+extern void HostSession_Run(const HOST_SESSION_CONFIG *config, HOST_SESSION_RESULT *result);
+
+/**
+  * @brief  Prints a session result.
+  * @param  name: The session name.
+  * @param  result: A pointer to the session result.
+  * @retval None.
+  */
+extern void HostSession_Print(const char *name, const HOST_SESSION_RESULT *result);
+
+
+#endif  //  __HOST_SESSION_H
@@ -0,0 +1,143 @@
+/**
+  ******************************************************************************
+  * @file    		receiver_test.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test of the double-buffered receiver in a simulated update session.
+	*
+	*							Built and run on the host, from this directory:
+	*							gcc -std=c99 -I.. -I../.. -o /tmp/receiver_test
+	*								receiver_test.c host_session.c host_compress.c host_flash.c ../bootloader.c
+	*								../receiver.c ../transmitter.c ../encryption.c ../can_address.c
+	*								../decompress.c ../delta.c ../page_writer.c
+	*							/tmp/receiver_test
+	*
+	*							The update time is compared with the bootloader replying after each
+	*							flash write, and a failed flash write must be reported and recovered.
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include "ecconet.h"
+#include "host_session.h"
+
+
+//	the image size, which does not end on a page boundary
+#define IMAGE_SIZE        0x190A0
+
+//	checks a test condition
+#define CHECK(condition)  Check((condition), #condition, __LINE__)
+
+
+//	private methods
+static void Check(bool condition, const char *text, int line);
+static bool IsImageWritten(void);
+
+
+//	the image
+static uint8_t image[IMAGE_SIZE];
+
+//	the number of failed checks
+static int numFailures;
+
+
+/**
+  * @brief  Runs the tests.
+  * @param  None.
+  * @retval Returns 0 if all tests pass, else 1.
+  */
+int main(void)
+{
+	HOST_SESSION_CONFIG config;
+	HOST_SESSION_RESULT pipelined, serialized, result;
+	uint32_t i, seed = 1;
+
+	//	build the image
+	for (i = 0; i < IMAGE_SIZE; ++i)
+	{
+		seed = (seed * 1103515245) + 12345;
+		image[i] = (uint8_t)(seed >> 16);
+	}
+	memset(&config, 0, sizeof(config));
+	config.image = image;
+	config.imageSize = IMAGE_SIZE;
+
+	//	the bootloader replies before writing flash, so the next segment is received meanwhile
+	HostSession_Run(&config, &pipelined);
+	HostSession_Print("reply before write", &pipelined);
+	CHECK(pipelined.isRebooted);
+	CHECK(IsImageWritten());
+	CHECK(pipelined.numSegmentsSent == pipelined.numSegments);
+	CHECK(0 == pipelined.numErrorReplies);
+
+	//	the host waits for each flash write, as when the bootloader replied after writing
+	config.isReplyAfterWrite = true;
+	HostSession_Run(&config, &serialized);
+	HostSession_Print("reply after write", &serialized);
+	CHECK(serialized.isRebooted);
+	CHECK(IsImageWritten());
+	CHECK(pipelined.timeUs < serialized.timeUs);
+	printf("update time saved: %.1f%%\n", 100.0 * (serialized.timeUs - pipelined.timeUs) / serialized.timeUs);
+	config.isReplyAfterWrite = false;
+
+	//	a page that fails to program is reported in the next reply, and the host restarts before it
+	config.failWriteNumber = pipelined.numFlashWrites / 2;
+	HostSession_Run(&config, &result);
+	HostSession_Print("failed write mid-image", &result);
+	CHECK(result.isRebooted);
+	CHECK(IsImageWritten());
+	CHECK(1 == result.numErrorReplies);
+
+	//	the last page fails to program, which is reported instead of rebooting
+	config.failWriteNumber = pipelined.numFlashWrites;
+	HostSession_Run(&config, &result);
+	HostSession_Print("failed last write", &result);
+	CHECK(result.isRebooted);
+	CHECK(IsImageWritten());
+	CHECK(1 == result.numErrorReplies);
+
+	if (numFailures)
+	{
+		printf("receiver_test: %d checks failed\n", numFailures);
+		return 1;
+	}
+	printf("receiver_test: all checks passed\n");
+	return 0;
+}
+
+
+//	private methods.................................
+
+/**
+  * @brief  Counts and prints a failed check.
+  * @param  condition: The check condition.
+  * @param  text: The check text.
+  * @param  line: The check line number.
+  * @retval None.
+  */
+static void Check(bool condition, const char *text, int line)
+{
+	if (condition)
+		return;
+	++numFailures;
+	printf("line %d: check failed: %s\n", line, text);
+}
+
+/**
+  * @brief  Checks that the image was written to the application area.
+  * @param  None.
+  * @retval True if the application area holds the image.
+  */
+static bool IsImageWritten(void)
+{
+	return (0 == memcmp(HostFlash_Pointer(HOST_SESSION_APP_ADDRESS), image, IMAGE_SIZE));
+}
@@ -0,0 +1,230 @@
+/**
+  ******************************************************************************
+  * @file    		verify_test.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		Host test and cold boot timing of the verified-image marker.
+	*
+	*							Built and run on the host, from this directory:
+	*							gcc -std=c99 -O2 -I.. -I../.. -o /tmp/verify_test
+	*								verify_test.c host_matrix_app.c host_flash.c ../../matrix_firmware_crc.c
+	*								../../matrix_crc.c ../bootloader.c ../receiver.c ../transmitter.c
+	*								../encryption.c ../can_address.c ../decompress.c ../delta.c ../page_writer.c
+	*							/tmp/verify_test
+	*
+	*							An image corrupted after the marker is written still passes the marker,
+	*							so the application checks the image against its footer in the background
+	*							and clears the marker, after which the bootloader refuses the image.
+	*							The cold boot time is compared with and without the marker.
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#include <string.h>
+#include <time.h>
+#include "ecconet.h"
+#include "bootloader_interface.h"
+#include "bootloader.h"
+#include "host_flash.h"
+#include "host_matrix_app.h"
+
+
+//	the flash layout, with a small and a large application area
+#define APP_ADDRESS       (HOST_FLASH_ADDRESS + 0x1000)
+#define SMALL_APP_SIZE    0x8000
+#define LARGE_APP_SIZE    0x40000
+#define MARKER_ADDRESS    (HOST_FLASH_ADDRESS + 0x60000)
+
+//	the number of cold boots timed
+#define NUM_BOOTS         200
+
+//	an interface table for an application area size and marker address
+#define INTERFACE_TABLE(appSize, markerAddress) \
+	{ NULL, &productInfo, APP_ADDRESS, (appSize), NULL, HostFlash_WriteWithErase, \
+		NULL, NULL, NULL, 0, 0, (markerAddress) }
+
+//	checks a test condition
+#define CHECK(condition)  Check((condition), #condition, __LINE__)
+
+
+//	private methods
+static void Check(bool condition, const char *text, int line);
+static void ClearVerifiedMarker(void);
+static void WriteImage(uint32_t size);
+static bool IsMarkerSet(void);
+static double TimeColdBoot(const BOOTLOADER_INTERFACE_TABLE *table);
+
+
+//	the product info, and the interface tables with and without the marker
+static const BOOTLOADER_PRODUCT_INFO_STRUCT productInfo = { "VerifyTest", "ECCO", "1", "1.0", "1.0", "", "" };
+static const BOOTLOADER_INTERFACE_TABLE smallTable = INTERFACE_TABLE(SMALL_APP_SIZE, MARKER_ADDRESS);
+static const BOOTLOADER_INTERFACE_TABLE largeTable = INTERFACE_TABLE(LARGE_APP_SIZE, MARKER_ADDRESS);
+static const BOOTLOADER_INTERFACE_TABLE smallTableNoMarker = INTERFACE_TABLE(SMALL_APP_SIZE, 0);
+static const BOOTLOADER_INTERFACE_TABLE largeTableNoMarker = INTERFACE_TABLE(LARGE_APP_SIZE, 0);
+
+//	the number of application firmware CRC errors reported, and the number of failed checks
+static int numCrcErrors;
+static int numFailures;
+
+
+/**
+  * @brief  Runs the tests.
+  * @param  None.
+  * @retval Returns 0 if all tests pass, else 1.
+  */
+int main(void)
+{
+	const BOOTLOADER_INTERFACE_TABLE *tables[2][2] =
+		{ { &smallTableNoMarker, &smallTable }, { &largeTableNoMarker, &largeTable } };
+	double before, after;
+	uint8_t t;
+
+	//	a verified image sets the marker, and the next boot passes on the marker
+	HostFlash_Reset(1024);
+	WriteImage(SMALL_APP_SIZE);
+	CHECK(!IsMarkerSet());
+	CHECK(Bootloader_VerifyApp(&smallTable));
+	CHECK(IsMarkerSet());
+	CHECK(Bootloader_VerifyApp(&smallTable));
+
+	//	the application finds the intact image matches its footer
+	numCrcErrors = 0;
+	HostMatrixApp_CheckFirmware(APP_ADDRESS, SMALL_APP_SIZE, ClearVerifiedMarker);
+	CHECK(0 == numCrcErrors);
+	CHECK(IsMarkerSet());
+
+	//	an image corrupted later still passes on the marker
+	HostFlash_Pointer(APP_ADDRESS)[0x1234] ^= 0x10;
+	CHECK(Bootloader_VerifyApp(&smallTable));
+
+	//	until the application finds the mismatch and clears the marker,
+	//	after which the bootloader computes the CRC32 and refuses the image
+	HostMatrixApp_CheckFirmware(APP_ADDRESS, SMALL_APP_SIZE, ClearVerifiedMarker);
+	CHECK(1 == numCrcErrors);
+	CHECK(!IsMarkerSet());
+	CHECK(!Bootloader_VerifyApp(&smallTable));
+	CHECK(!IsMarkerSet());
+
+	//	without the method the footer is not checked
+	numCrcErrors = 0;
+	HostMatrixApp_CheckFirmware(APP_ADDRESS, SMALL_APP_SIZE, NULL);
+	CHECK(0 == numCrcErrors);
+
+	//	an image without a footer is reported
+	HostFlash_Pointer(APP_ADDRESS + SMALL_APP_SIZE - sizeof(ECCONET_FLASH_FILE_FOOTER))[0] ^= 0x01;
+	HostMatrixApp_CheckFirmware(APP_ADDRESS, SMALL_APP_SIZE, ClearVerifiedMarker);
+	CHECK(1 == numCrcErrors);
+
+	//	the cold boot time, computing the CRC32 every boot and passing on the marker
+	for (t = 0; t < 2; ++t)
+	{
+		HostFlash_Reset(1024);
+		WriteImage(tables[t][1]->appFlashSize);
+		before = TimeColdBoot(tables[t][0]);
+		CHECK(!IsMarkerSet());
+		CHECK(Bootloader_VerifyApp(tables[t][1]));
+		CHECK(IsMarkerSet());
+		after = TimeColdBoot(tables[t][1]);
+		printf("%3u KB application: cold boot verify %8.1f us computing the CRC32, %6.3f us on the marker\n",
+			(unsigned)(tables[t][1]->appFlashSize / 1024), before * 1e6, after * 1e6);
+	}
+
+	if (numFailures)
+	{
+		printf("verify_test: %d checks failed\n", numFailures);
+		return 1;
+	}
+	printf("verify_test: all checks passed\n");
+	return 0;
+}
+
+
+//	private methods.................................
+
+/**
+  * @brief  Counts and prints a failed check.
+  * @param  condition: The check condition.
+  * @param  text: The check text.
+  * @param  line: The check line number.
+  * @retval None.
+  */
+static void Check(bool condition, const char *text, int line)
+{
+	if (condition)
+		return;
+	++numFailures;
+	printf("line %d: check failed: %s\n", line, text);
+}
+
+/**
+  * @brief  The application firmware CRC error method, which clears the marker as a product would.
+  * @param  None.
+  * @retval None.
+  */
+static void ClearVerifiedMarker(void)
+{
+	++numCrcErrors;
+	Bootloader_ClearVerifiedMarker(&smallTable);
+}
+
+/**
+  * @brief  Writes a pseudo-random image with a flash file footer to the application area.
+  * @param  size: The image size.
+  * @retval None.
+  */
+static void WriteImage(uint32_t size)
+{
+	ECCONET_FLASH_FILE_FOOTER footer;
+	uint8_t *image = HostFlash_Pointer(APP_ADDRESS);
+	uint32_t i, seed = 1;
+
+	for (i = 0; i < size; ++i)
+	{
+		seed = (seed * 1103515245) + 12345;
+		image[i] = (uint8_t)(seed >> 16);
+	}
+	memset(&footer, 0, sizeof(footer));
+	footer.codebaseKey = ECCONET_FLASH_FILE_FOOTER_KEY;
+	strncpy(footer.modelName, productInfo.modelName, sizeof(footer.modelName));
+	footer.appAddress = APP_ADDRESS;
+	memcpy(&image[size - sizeof(footer)], &footer, sizeof(footer));
+	footer.appCRC32 = Bootloader_ComputeCRC32(image, size - 4);
+	memcpy(&image[size - 4], &footer.appCRC32, 4);
+}
+
+/**
+  * @brief  Checks whether the verified-image marker is set.
+  * @param  None.
+  * @retval True if the marker is set.
+  */
+static bool IsMarkerSet(void)
+{
+	return (BOOTLOADER_VERIFIED_MARKER_KEY == *(uint32_t *)HostFlash_Pointer(MARKER_ADDRESS));
+}
+
+/**
+  * @brief  Times the application verify of a cold boot.
+  * @param  table: The interface table.
+  * @retval The time in seconds of one verify.
+  */
+static double TimeColdBoot(const BOOTLOADER_INTERFACE_TABLE *table)
+{
+	clock_t start;
+	uint32_t boot, numBoots = NUM_BOOTS;
+
+	//	the marker check is too fast to time a few boots
+	if (0 != table->verifiedMarkerAddress)
+		numBoots *= 100000;
+	start = clock();
+	for (boot = 0; boot < numBoots; ++boot)
+		CHECK(Bootloader_VerifyApp(table));
+	return (double)(clock() - start) / CLOCKS_PER_SEC / numBoots;
+}
@@ -31,6 +31,10 @@
 TRANSMITTER_OBJECT Transmitter;
 
 
+//	private methods
+static void SendFrame(void);
+
+
 
 /**
   * @brief  Resets and configures the transmitter.
@@ -39,8 +43,27 @@ TRANSMITTER_OBJECT Transmitter;
   */
 void Transmitter_Reset(void)
 {
-	//	reset the frame index
+	//	reset the frame index and queue
 	Transmitter.frame.idBits.frameIndex = 0;
+	Transmitter.queueHead = 0;
+	Transmitter.queueTail = 0;
+}
+
+/**
+  * @brief  Clocks the transmitter, sending queued frames until the CAN transmitter is busy.
+  * @param  None.
+  * @retval None.
+  */
+void Transmitter_Clock(void)
+{
+	//	if no interface then just return
+	if (NULL == Bootloader.appInterface->trySendCanFrame)
+		return;
+	
+	//	send frames until the queue is empty or the transmitter is busy
+	while ((Transmitter.queueTail != Transmitter.queueHead)
+		&& (0 == Bootloader.appInterface->trySendCanFrame(&Transmitter.queue[Transmitter.queueTail])))
+		Transmitter.queueTail = (Transmitter.queueTail + 1) % TRANSMITTER_QUEUE_SIZE;
 }
 
 /**
@@ -107,7 +130,7 @@ void Transmitter_Finish(void)
 	bool multiFrame;
 	
 	//	if no interface then just return
-	if (NULL == Bootloader.appInterface->sendCanFrame)
+	if ((NULL == Bootloader.appInterface->sendCanFrame) && (NULL == Bootloader.appInterface->trySendCanFrame))
 		return;
 
 	//	total size
@@ -133,7 +156,7 @@ void Transmitter_Finish(void)
 			(totalSize ? ENET_MESSAGE_FRAME_TYPE_BODY : ENET_MESSAGE_FRAME_TYPE_LAST);
 		Transmitter.frame.dataSize = bytesToSend;
 		memcpy(Transmitter.frame.data, Transmitter.pData, bytesToSend);
-		Bootloader.appInterface->sendCanFrame(&Transmitter.frame);
+		SendFrame();
 		
 		//	bump data pointer and frame index
 		Transmitter.pData += bytesToSend;
@@ -226,4 +249,59 @@ void Transmitter_SendWriteFixedSegmentReply(uint8_t destinationAddress, uint8_t
 	Transmitter_Finish();
 }	
 
+/**
+  * @brief  Sends the multicast missing segments reply.
+  * @param  destinationAddress: The destination address.
+  * @param  code: The bootloader status code.
+  * @param  numSegments: The number of segments in the multicast session.
+  * @param  receivedSegments: A bitmap of the segments received, LSB first.
+  * @retval None.
+  */
+void Transmitter_SendMissingSegmentsReply(uint8_t destinationAddress, uint8_t code,
+	uint16_t numSegments, const uint8_t *receivedSegments)
+{
+	uint16_t i, numBytes;
+	
+	//	send message
+	Transmitter_StartMessage(destinationAddress);
+	Transmitter_AddValueBigEndian(KeyResponseFileWriteFixedSegment, 2);
+	Transmitter_AddData(&code, 1);
+	Transmitter_AddValueBigEndian(numSegments, 2);
+	numBytes = (numSegments + 7) >> 3;
+	for (i = 0; i < numBytes; ++i)
+		*Transmitter.pData++ = ~receivedSegments[i];
+	if (numSegments & 7)
+		Transmitter.pData[-1] &= (1 << (numSegments & 7)) - 1;
+	Transmitter_Finish();
+}
+
+
+//	private methods.................................
 
+/**
+  * @brief  Queues the message frame for sending, or sends it if frames are not queued.
+  *         If the queue is full, then waits for room.
+  * @param  None.
+  * @retval None.
+  */
+static void SendFrame(void)
+{
+	uint8_t nextHead;
+	
+	//	if frames are not queued, then send the frame
+	if (NULL == Bootloader.appInterface->trySendCanFrame)
+	{
+		Bootloader.appInterface->sendCanFrame(&Transmitter.frame);
+		return;
+	}
+	
+	//	wait for room in the queue
+	nextHead = (Transmitter.queueHead + 1) % TRANSMITTER_QUEUE_SIZE;
+	while (nextHead == Transmitter.queueTail)
+		Transmitter_Clock();
+	
+	//	queue the frame and start sending
+	Transmitter.queue[Transmitter.queueHead] = Transmitter.frame;
+	Transmitter.queueHead = nextHead;
+	Transmitter_Clock();
+}
@@ -28,6 +28,9 @@
 #include "ecconet.h"
 
 
+//	the number of frames that may be queued for sending
+#define TRANSMITTER_QUEUE_SIZE  16
+
 /**
   * @brief  The transmitter data object.
   */
@@ -36,6 +39,11 @@ typedef struct
 	//	the message frame
 	ENET_CAN_FRAME frame;
 	
+	//	the queue of frames waiting to be sent, and the queue head and tail indices
+	ENET_CAN_FRAME queue[TRANSMITTER_QUEUE_SIZE];
+	uint8_t queueHead;
+	uint8_t queueTail;
+	
 	//	the message data
 	uint8_t buffer[262] __attribute__((aligned(4)));
 	
@@ -53,6 +61,13 @@ extern TRANSMITTER_OBJECT Transmitter;
   */
 extern void Transmitter_Reset(void);
 
+/**
+  * @brief  Clocks the transmitter, sending queued frames until the CAN transmitter is busy.
+  * @param  None.
+  * @retval None.
+  */
+extern void Transmitter_Clock(void);
+
 /**
   * @brief  Resets the transmitter for a new message.
 	* @param  destinationAddress: The destination address, or zero for broadcast.
@@ -119,6 +134,17 @@ extern void Transmitter_SendInfoFileReply(uint8_t destinationAddress, bool isInf
   */
 extern void Transmitter_SendInfoFileSegmentReply(uint8_t destinationAddress);
 
+/**
+  * @brief  Sends the multicast missing segments reply.
+  * @param  destinationAddress: The destination address.
+  * @param  code: The bootloader status code.
+  * @param  numSegments: The number of segments in the multicast session.
+  * @param  receivedSegments: A bitmap of the segments received, LSB first.
+  * @retval None.
+  */
+extern void Transmitter_SendMissingSegmentsReply(uint8_t destinationAddress, uint8_t code,
+	uint16_t numSegments, const uint8_t *receivedSegments);
+
 
 
 #endif  //  __TRANSMITTER_H
@@ -26,6 +26,8 @@
 #include "matrix_ftp_client.h"
 #include "matrix_ftp_server.h"
 #include "matrix_event_index.h"
+#include "matrix_node_table.h"
+#include "matrix_firmware_crc.h"
 #include "matrix_lib_interface.h"
 #include "matrix.h"
 
@@ -33,6 +35,7 @@
 //	private methods
 extern MATRIX_RECEIVER MatrixReceiver;
 int Matrix_PrivateSendCanToken(TOKEN *token);
+uint32_t Matrix_PrivateGetFirstStatusTime(void);
 void Matrix_SendUpdateCheckAck(uint32_t address);
 void Matrix_DelayStatusUpdate15mS(void);
 
@@ -52,10 +55,13 @@ void Matrix_Reset(const MATRIX_INTERFACE_TABLE *appInterface, uint32_t systemTim
 	
 	//	set the system time and the next status time
 	Matrix.systemTime = systemTime;
-	Matrix.nextStatusTime = systemTime + 1200;
+	Matrix.nextStatusTime = Matrix_PrivateGetFirstStatusTime();
+	Matrix.isStatusSuppressed = false;
 
 	//	init Matrix modules
 	MatrixEventIndex_Reset();
+	MatrixNodeTable_Reset();
+	MatrixFirmwareCrc_Reset();
 	MatrixTimeLogic_Reset(MATRIX_TIME_LOGIC_FILE_NAME_0);
 	MatrixReceiver_Reset();
 	MatrixTransmitter_Reset();
@@ -92,11 +98,20 @@ void Matrix_Clock(uint32_t systemTime)
 	MatrixFTPServer_Clock();
 	MatrixFTPClient_Clock();
 	MatrixTokenSequencerController_Clock();
+	MatrixNodeTable_Clock();
+	MatrixFirmwareCrc_Clock();
+
+	//	if status suppression timed out, then resume status
+	if (Matrix.isStatusSuppressed && IsMatrixTimerExpired(Matrix.statusSuppressEndTime))
+	{
+		Matrix.isStatusSuppressed = false;
+		Matrix.nextStatusTime = Matrix_PrivateGetFirstStatusTime();
+	}
 
 	//	if time to send status and status tokens to send 
-	//	and not running ftp and CAN address is valid
+	//	and not running ftp and status not suppressed and CAN address is valid
 	if (IsMatrixTimerExpired(Matrix.nextStatusTime) /*&& MatrixTimeLogic.tokenTableHasBroadcastTokens*/ 
-		&& (0 == MatrixReceiver.senderAddressFilter) && Matrix_IsCanAddressValid())
+		&& (0 == MatrixReceiver.sessionAddress) && !Matrix.isStatusSuppressed && Matrix_IsCanAddressValid())
 	{
 		//	set next message time
 		Matrix.nextStatusTime += (Matrix_GetCanAddress() + (1000 - 60));
@@ -208,6 +223,38 @@ int Matrix_SendSync(TOKEN *token)
 	return 0;
 }
 
+/**
+  * @brief  Gets the time of the first status broadcast after power-on or address adoption.
+	*					The delay is spread across the first status window by the device GUID,
+	*					or by the CAN address if no GUID is available.
+	* @param  None.
+  * @retval The system time of the first status broadcast.
+  */
+uint32_t Matrix_PrivateGetFirstStatusTime(void)
+{
+	uint32_t guid[4], hash;
+	
+	//	get the GUID
+	if ((NULL != Matrix.appInterface) && (NULL != Matrix.appInterface->get128BitGuid))
+	{
+		Matrix.appInterface->get128BitGuid(guid);
+		hash = guid[0] ^ guid[1] ^ guid[2] ^ guid[3];
+	}
+	else  //  no guid available
+	{
+		hash = Matrix_GetCanAddress();
+	}
+	
+	//	mix the bits so that nearby values spread across the window
+	hash ^= (hash >> 16);
+	hash *= 0x45D9F3B;
+	hash ^= (hash >> 16);
+	
+	//	return the first status time
+	return Matrix.systemTime + MATRIX_FIRST_STATUS_DELAY_MS
+		+ (hash % (MATRIX_FIRST_STATUS_WINDOW_MS + 1));
+}
+
 /**
   * @brief  Delays the status update by up to 15 mS from original next scheduled time.
   *         Note: This does *not* delay input or output events. 
@@ -234,6 +281,7 @@ void Matrix_PrivateReceiveCanToken(TOKEN *token)
 	
 	//	manage address before handling other types of tokens
 	MatrixCanAddress_CanTokenIn(*token);
+	MatrixNodeTable_CanTokenIn(token);
 	
 	//	if this device's working CAN address is valid
 	if (Matrix_IsCanAddressValid())
@@ -250,6 +298,25 @@ void Matrix_PrivateReceiveCanToken(TOKEN *token)
 		if (KeyPrefix_Command == prefix)
 			MatrixTokenSequencerController_TokenIn(token);
 		
+		//	answer app firmware CRC requests from the cache
+		MatrixFirmwareCrc_CanTokenIn(token);
+		
+		//	suppress the periodic status until allowed again or timed out,
+		//	events are still sent
+		if ((KeyRequestSuppressStatus == token->key) && (TOKEN_VALUE_SUPPRESS_STATUS == (uint32_t)token->value))
+		{
+			Matrix.isStatusSuppressed = true;
+			Matrix.statusSuppressEndTime = Matrix.systemTime + MATRIX_STATUS_SUPPRESS_TIMEOUT_MS;
+		}
+		
+		//	allow the periodic status, spreading the first status of all devices
+		else if ((KeyRequestAllowStatus == token->key) && (TOKEN_VALUE_ALLOW_STATUS == (uint32_t)token->value)
+			&& Matrix.isStatusSuppressed)
+		{
+			Matrix.isStatusSuppressed = false;
+			Matrix.nextStatusTime = Matrix_PrivateGetFirstStatusTime();
+		}
+		
 		//	all tokens go to the application
 		if ((NULL != Matrix.appInterface) && (NULL != Matrix.appInterface->tokenCallback))
 			 Matrix.appInterface->tokenCallback(token);
@@ -45,6 +45,10 @@ typedef struct
 	//	output status timer
 	uint32_t nextStatusTime;
 	
+	//	status suppressed flag, and the time that suppression ends
+	bool isStatusSuppressed;
+	uint32_t statusSuppressEndTime;
+	
 	//	app interface structure
 	const MATRIX_INTERFACE_TABLE *appInterface;
 	
@@ -26,6 +26,7 @@
 
 //	private methods
 extern int Matrix_PrivateSendCanToken(TOKEN *token);
+extern uint32_t Matrix_PrivateGetFirstStatusTime(void);
 uint8_t MatrixCanAddress_GetNextProposedCanAddress(void);
 int MatrixCanAddress_SendAddressNegotiationToken(TOKEN *token);
 
@@ -44,6 +45,7 @@ MATRIX_CAN_ADDRESS_OBJECT MatrixCanAddress;
 void MatrixCanAddress_Reset(void)
 {
 	TOKEN token;
+	MATRIX_CAN_ADDRESS_FILE_OBJECT lastAddressFile;
 	uint32_t timestamp;
 	
 	//	The device CAN address may be programmed as a static via GUI
@@ -68,6 +70,15 @@ void MatrixCanAddress_Reset(void)
 	MatrixCanAddress.xorIndex = 0;
 	MatrixCanAddress.proposedAddress = 0;
 	
+	//	get the last self-assigned address, which is proposed first
+	MatrixCanAddress.savedAddress = 0;
+	if ((0 == FlashDrive_ReadFile(MATRIX_CAN_ADDRESS_FILE_VOLUME_INDEX, MATRIX_LAST_CAN_ADDRESS_FILE_NAME,
+		&lastAddressFile, sizeof(MATRIX_CAN_ADDRESS_FILE_OBJECT), &timestamp))
+		&& (lastAddressFile.address >= MATRIX_CAN_MIN_STANDARD_ADDRESS)
+		&& (lastAddressFile.address <= MATRIX_CAN_MAX_STANDARD_ADDRESS))
+		MatrixCanAddress.savedAddress = lastAddressFile.address;
+	MatrixCanAddress.reclaimAddress = MatrixCanAddress.savedAddress;
+	
 	//	if address is static, then send message to system
 	if (MatrixCanAddress.file.isStatic)
 	{
@@ -88,6 +99,7 @@ void MatrixCanAddress_Reset(void)
 void MatrixCanAddress_Clock(void)
 {
 	TOKEN token;
+	MATRIX_CAN_ADDRESS_FILE_OBJECT lastAddressFile;
 	
 	//	if CAN address is not valid
 	if (!Matrix_IsCanAddressValid())
@@ -95,25 +107,47 @@ void MatrixCanAddress_Clock(void)
 		//	if have not proposed an address
 		if (0 == MatrixCanAddress.proposedAddress)
 		{
-			//	get and send next proposed address
-			MatrixCanAddress.proposedAddress =
-				MatrixCanAddress_GetNextProposedCanAddress();
+			//	if not yet tried, then propose the last self-assigned address
+			//	and claim it in a shorter time, since it is likely still free
+			if (0 != MatrixCanAddress.reclaimAddress)
+			{
+				MatrixCanAddress.proposedAddress = MatrixCanAddress.reclaimAddress;
+				MatrixCanAddress.reclaimAddress = 0;
+				MatrixCanAddress.requestTime = Matrix.systemTime + DEVICE_ADDRESS_RECLAIM_TIME_MS;
+			}
+			
+			//	else get the next proposed address
+			else
+			{
+				MatrixCanAddress.proposedAddress =
+					MatrixCanAddress_GetNextProposedCanAddress();
+				MatrixCanAddress.requestTime = Matrix.systemTime + DEVICE_ADDRESS_CLAIM_TIME_MS;
+			}
+			
+			//	send the proposed address
 			token.key = KeyRequestAddress;
 			token.value = MatrixCanAddress.proposedAddress;
 			token.address = 0;
 			Matrix_PrivateSendCanToken(&token);
-			
-			//	claim address in 100 mS
-			MatrixCanAddress.requestTime = Matrix.systemTime + 100;
 		}
 	
 		//	else if proposed an address and did not received an address-in-use message
-		//	before the 100 mS timer expired
+		//	before the claim timer expired
 		else if (IsMatrixTimerExpired(MatrixCanAddress.requestTime))
 		{
 			//	adopt address
 			MatrixCanAddress.file.address = MatrixCanAddress.proposedAddress;
 			MatrixCanAddress.proposedAddress = 0;
+			
+			//	if a new address, then save it to propose first after the next reset
+			if (MatrixCanAddress.file.address != MatrixCanAddress.savedAddress)
+			{
+				MatrixCanAddress.savedAddress = MatrixCanAddress.file.address;
+				lastAddressFile.address = MatrixCanAddress.file.address;
+				lastAddressFile.isStatic = 0;
+				FlashDrive_WriteFile(MATRIX_CAN_ADDRESS_FILE_VOLUME_INDEX, MATRIX_LAST_CAN_ADDRESS_FILE_NAME,
+					&lastAddressFile, sizeof(MATRIX_CAN_ADDRESS_FILE_OBJECT), 0);
+			}
 
 			//	notify other devices in the system that the address is in use
 			token.key = KeyResponseAddressInUse;
@@ -121,8 +155,8 @@ void MatrixCanAddress_Clock(void)
 			token.address = 0;
 			Matrix_PrivateSendCanToken(&token);
 			
-			//	send the first status update in 1200 mS
-			Matrix.nextStatusTime = Matrix.systemTime + 1200;
+			//	schedule the first status update
+			Matrix.nextStatusTime = Matrix_PrivateGetFirstStatusTime();
 		}
 	}
 }
@@ -49,6 +49,12 @@ typedef struct
 	//	proposed address
 	uint8_t proposedAddress;
 	
+	//	the last self-assigned address as saved in flash, or zero if none
+	uint8_t savedAddress;
+	
+	//	the saved address to propose first, or zero once proposed
+	uint8_t reclaimAddress;
+	
 	//	the device address and static flag
 	MATRIX_CAN_ADDRESS_FILE_OBJECT file;
 	
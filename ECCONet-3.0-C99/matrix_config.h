@@ -49,8 +49,16 @@
 //	Cache frames in tx message stream.
 #define CAN_TX_STREAM_BUFFER_SIZE						  40
 
+//	Cache frames in rx ftp session stream, which must hold a whole file segment message.
+#define CAN_RX_SESSION_STREAM_BUFFER_SIZE			40
+
 #endif
 
+//	If you need the ftp server to read ahead the next file segment on volumes
+//	that are not pointer-accessible, define this as a preprocessor symbol.
+//	This adds a MATRIX_FTP_MAX_SEGMENT_LENGTH buffer to the ftp server.
+//#define MATRIX_FTP_SERVER_READ_AHEAD
+
 //  End RAM allocation section
 
 
@@ -92,7 +100,7 @@
 #define MATRIX_MESSAGE_FRAME_TYPE_SINGLE				0x1E
 */
 
-//	optimized
+//	optimized, also used by the bootloader library unless built with ENET_LEGACY_FRAME_TYPES
 #define MATRIX_MESSAGE_FRAME_TYPE_SINGLE				0x1C
 #define MATRIX_MESSAGE_FRAME_TYPE_BODY					0x1D
 #define MATRIX_MESSAGE_FRAME_TYPE_LAST					0x1E
@@ -134,17 +142,57 @@
 //	Maximum guid index for creating an address.
 #define DEVICE_ADDRESS_MAX_GUID_INDEX						((128 / 7) + 1)
 
+//	Time to wait for an address-in-use response before claiming a proposed address,
+//	and the shorter time when reclaiming the last self-assigned address after reset.
+#define DEVICE_ADDRESS_CLAIM_TIME_MS						100
+#define DEVICE_ADDRESS_RECLAIM_TIME_MS						30
+
+//	Delay from power-on or address adoption to the first status broadcast,
+//	and the window over which the first broadcast is spread by device GUID,
+//	so that devices powered on together do not all broadcast at once.
+#define MATRIX_FIRST_STATUS_DELAY_MS						1200
+#define MATRIX_FIRST_STATUS_WINDOW_MS						800
+
+//	Longest time that a suppress-status request holds off the periodic status broadcast,
+//	in case the device that requested it never allows status again.
+#define MATRIX_STATUS_SUPPRESS_TIMEOUT_MS				30000
+
+//	Number of app firmware image bytes added to the cached firmware CRC per clock.
+#define MATRIX_FIRMWARE_CRC_SLICE_SIZE					1024
+
 //	FTP params
 #define MATRIX_MAX_FILE_NAME_LENGTH									12
 #define MATRIX_MAX_FILE_SEGMENT_LENGTH						 256
 #define MATRIX_MAX_FILE_SEGMENT_LENGTH_SHIFT				 8
 #define MATRIX_MAX_FILE_REQUEST_RESPONSE_TIME_MS	 1000
-#define MATRIX_MAX_SENDER_ADDRESS_FILTER_TIME_MS	 1000
+
+//	FTP negotiated segment length limits, which must be powers of two
+//	A segment message must fit in both the tx and rx stream buffers,
+//	so segments above the default also need a custom RAM allocation.
+#define MATRIX_FTP_MIN_SEGMENT_LENGTH								 64
+#ifndef MATRIX_FTP_MAX_SEGMENT_LENGTH
+#define MATRIX_FTP_MAX_SEGMENT_LENGTH								 MATRIX_MAX_FILE_SEGMENT_LENGTH
+#endif
+#define MATRIX_MAX_RX_SESSION_TIME_MS							 1000
+
+//	The rx session stream must hold the largest segment message, which is a file write segment
+//	request of event index, key, segment index, access code, segment data and checksum.
+#if ((CAN_RX_SESSION_STREAM_BUFFER_SIZE * CAN_FRAME_MAX_NUM_BYTES) < (1 + 2 + 2 + 4 + MATRIX_FTP_MAX_SEGMENT_LENGTH + 2))
+#error "CAN_RX_SESSION_STREAM_BUFFER_SIZE must hold a whole MATRIX_FTP_MAX_SEGMENT_LENGTH segment message"
+#endif
 #define MATRIX_SERVER_ACCESS_POLY						 0x5EB9417D
 
+//	FTP directory listing page size in bytes, excluding the response key and checksum
+//	This must fit in both the tx and rx stream buffers, the same as a file segment.
+#define MATRIX_FTP_DIRECTORY_PAGE_SIZE							 MATRIX_MAX_FILE_SEGMENT_LENGTH
+
 //	CRC Checksum size
 #define MATRIX_MESSAGE_CRC_SIZE											 2
 
+//	the time after which a node that has not been seen is considered offline
+//	this must be well under 65 seconds
+#define MATRIX_NODE_TABLE_TIMEOUT_MS							5000
+
 //	the shelf life of a received CAN frame
 #define MATRIX_RECEIVED_FRAME_TIMEOUT_MS           750
 
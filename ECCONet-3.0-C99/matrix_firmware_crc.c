@@ -0,0 +1,198 @@
+/**
+  ******************************************************************************
+  * @file    		matrix_firmware_crc.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		The cached application firmware CRC.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+
+#include <string.h>
+#include "matrix.h"
+#include "matrix_crc.h"
+#include "matrix_firmware_crc.h"
+
+
+//	private methods
+extern int Matrix_PrivateSendCanToken(TOKEN *token);
+static void SendAppFirmwareCrc(uint8_t address);
+static void AddByteToCRC32(uint8_t byte, uint32_t *crc32);
+static void CheckFooterCrc32(void);
+
+
+/**
+  * @brief  The Matrix firmware CRC data object.
+  */
+MATRIX_FIRMWARE_CRC_OBJECT MatrixFirmwareCrc;
+
+
+/**
+  * @brief  Resets the firmware CRC and starts computing it.
+  * @param  None.
+  * @retval None.
+  */
+void MatrixFirmwareCrc_Reset(void)
+{
+	//	clear the object and start the CRC
+	memset(&MatrixFirmwareCrc, 0, sizeof(MATRIX_FIRMWARE_CRC_OBJECT));
+	MatrixFirmwareCrc.crc = MATRIX_MESSAGE_CRC_INIT_VALUE;
+	MatrixFirmwareCrc.crc32 = 0xffffffff;
+}
+
+/**
+  * @brief  Clocks the firmware CRC, adding one slice of the image per clock.
+	*					This method supports cooperative task scheduling.
+  * @param  None.
+  * @retval None.
+  */
+void MatrixFirmwareCrc_Clock(void)
+{
+	const MATRIX_FIRMWARE_IMAGE *image;
+	uint8_t *bytes;
+	uint32_t numBytes;
+	
+	//	if the CRC is cached or the app did not give the image location, then done
+	if (MatrixFirmwareCrc.isValid || (NULL == Matrix.appInterface)
+		|| (0 == Matrix.appInterface->appFirmwareImage.size))
+		return;
+	image = &Matrix.appInterface->appFirmwareImage;
+	
+	//	add the next slice to the CRC, and if checking the footer, to the footer CRC32,
+	//	which leaves out the last word
+	numBytes = image->size - MatrixFirmwareCrc.offset;
+	if (MATRIX_FIRMWARE_CRC_SLICE_SIZE < numBytes)
+		numBytes = MATRIX_FIRMWARE_CRC_SLICE_SIZE;
+	bytes = (uint8_t *)(uintptr_t)image->baseAddress + MatrixFirmwareCrc.offset;
+	while (numBytes--)
+	{
+		Matrix_AddByteToCRC16(*bytes, &MatrixFirmwareCrc.crc);
+		if ((NULL != Matrix.appInterface->appFirmwareCrcError) && ((MatrixFirmwareCrc.offset + 4) < image->size))
+			AddByteToCRC32(*bytes, &MatrixFirmwareCrc.crc32);
+		++bytes;
+		++MatrixFirmwareCrc.offset;
+	}
+	
+	//	if the image is done, then cache the CRC, check the footer and answer any waiting request
+	if (MatrixFirmwareCrc.offset >= image->size)
+	{
+		MatrixFirmwareCrc.isValid = true;
+		CheckFooterCrc32();
+		if (MatrixFirmwareCrc.isRequestPending)
+		{
+			MatrixFirmwareCrc.isRequestPending = false;
+			SendAppFirmwareCrc(MatrixFirmwareCrc.requesterAddress);
+		}
+	}
+}
+
+/**
+  * @brief  Checks incoming tokens for firmware CRC requests.
+	* @param  token: A message token.
+  * @retval None.
+  */
+void MatrixFirmwareCrc_CanTokenIn(TOKEN *token)
+{
+	//	if not an app firmware CRC request or the app did not give the image location, then done
+	if ((KeyRequestAppFirmwareCrc != token->key) || (NULL == Matrix.appInterface)
+		|| (0 == Matrix.appInterface->appFirmwareImage.size))
+		return;
+	
+	//	if the CRC is cached, then answer now
+	if (MatrixFirmwareCrc.isValid)
+	{
+		SendAppFirmwareCrc(token->address);
+	}
+	
+	//	else answer when the CRC is done
+	else
+	{
+		if (MatrixFirmwareCrc.isRequestPending && (MatrixFirmwareCrc.requesterAddress != token->address))
+			MatrixFirmwareCrc.requesterAddress = MATRIX_CAN_BROADCAST_ADDRESS;
+		else
+			MatrixFirmwareCrc.requesterAddress = token->address;
+		MatrixFirmwareCrc.isRequestPending = true;
+	}
+}
+
+/**
+  * @brief  Invalidates the cached application firmware CRC and starts computing it again.
+	* @param  None.
+  * @retval None.
+  */
+void Matrix_InvalidateAppFirmwareCrc(void)
+{
+	MatrixFirmwareCrc.crc = MATRIX_MESSAGE_CRC_INIT_VALUE;
+	MatrixFirmwareCrc.crc32 = 0xffffffff;
+	MatrixFirmwareCrc.offset = 0;
+	MatrixFirmwareCrc.isValid = false;
+}
+
+
+//	private methods....................................................................
+
+/**
+  * @brief  Sends the cached app firmware CRC.
+	* @param  address: The recipient CAN address.
+  * @retval None.
+  */
+static void SendAppFirmwareCrc(uint8_t address)
+{
+	TOKEN token;
+	
+	token.key = KeyResponseAppFirmwareCrc;
+	token.value = MatrixFirmwareCrc.crc;
+	token.address = address;
+	token.flags = 0;
+	Matrix_PrivateSendCanToken(&token);
+}
+
+/**
+  * @brief  Adds a byte to the footer CRC32, which is CRC32/BZIP2 as the bootloader computes it.
+	* @param  byte: A byte to add to the CRC32.
+	* @param  crc32: A pointer to the CRC32 accumulator.
+  * @retval None.
+  */
+static void AddByteToCRC32(uint8_t byte, uint32_t *crc32)
+{
+	uint8_t bit;
+	
+	*crc32 ^= ((uint32_t)byte << 24);
+	for (bit = 0; bit < 8; ++bit)
+		*crc32 = (*crc32 & 0x80000000) ? ((*crc32 << 1) ^ 0x04C11DB7) : (*crc32 << 1);
+}
+
+/**
+  * @brief  Checks the image against its flash file footer, and reports a mismatch to the application.
+	* @param  None.
+  * @retval None.
+  */
+static void CheckFooterCrc32(void)
+{
+	const MATRIX_FIRMWARE_IMAGE *image = &Matrix.appInterface->appFirmwareImage;
+	uint32_t footerKey, footerCrc32;
+	
+	//	if not checking the footer, then done
+	if (NULL == Matrix.appInterface->appFirmwareCrcError)
+		return;
+	
+	//	if the image has no footer, or the footer CRC32 does not match, then report it
+	if (MATRIX_FIRMWARE_FOOTER_SIZE <= image->size)
+	{
+		memcpy(&footerKey, (uint8_t *)(uintptr_t)(image->baseAddress + image->size - MATRIX_FIRMWARE_FOOTER_SIZE), 4);
+		memcpy(&footerCrc32, (uint8_t *)(uintptr_t)(image->baseAddress + image->size - 4), 4);
+		if ((MATRIX_FIRMWARE_FOOTER_KEY == footerKey) && (~MatrixFirmwareCrc.crc32 == footerCrc32))
+			return;
+	}
+	Matrix.appInterface->appFirmwareCrcError();
+}
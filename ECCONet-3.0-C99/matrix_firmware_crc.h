@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    		matrix_firmware_crc.h
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		The cached application firmware CRC.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __MATRIX_FIRMWARE_CRC_H
+#define __MATRIX_FIRMWARE_CRC_H
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix_config.h"
+#include "matrix_tokens.h"
+
+
+//	If the app gives the appFirmwareCrcError method, then the image must be the bootloader
+//	application area, which ends in an ECCONet flash file footer that starts with this key.
+//	The image is then also checked against the footer CRC32 in its last word.
+#define MATRIX_FIRMWARE_FOOTER_KEY   0xC0DEBA5E
+#define MATRIX_FIRMWARE_FOOTER_SIZE  48
+
+
+/**
+  * @brief  The Matrix firmware CRC data object.
+	*					The CRC is computed a slice per clock and then cached.
+  */
+typedef struct
+{
+	//	the CRC accumulator
+	uint16_t crc;
+	
+	//	the footer CRC32 accumulator
+	uint32_t crc32;
+	
+	//	the offset of the next byte to add to the CRC
+	uint32_t offset;
+	
+	//	the cached CRC is valid
+	bool isValid;
+	
+	//	a request is waiting for the CRC, and the requester address,
+	//	or the broadcast address if more than one device is waiting
+	bool isRequestPending;
+	uint8_t requesterAddress;
+	
+} MATRIX_FIRMWARE_CRC_OBJECT;
+//extern MATRIX_FIRMWARE_CRC_OBJECT MatrixFirmwareCrc;
+
+
+/**
+  * @brief  Resets the firmware CRC and starts computing it.
+  * @param  None.
+  * @retval None.
+  */
+extern void MatrixFirmwareCrc_Reset(void);
+
+/**
+  * @brief  Clocks the firmware CRC, adding one slice of the image per clock.
+	*					This method supports cooperative task scheduling.
+  * @param  None.
+  * @retval None.
+  */
+extern void MatrixFirmwareCrc_Clock(void);
+
+/**
+  * @brief  Checks incoming tokens for firmware CRC requests.
+	* @param  token: A message token.
+  * @retval None.
+  */
+extern void MatrixFirmwareCrc_CanTokenIn(TOKEN *token);
+
+
+#endif  //  __MATRIX_FIRMWARE_CRC_H
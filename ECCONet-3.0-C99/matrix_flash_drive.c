@@ -128,6 +128,7 @@ FLASH_DRIVE_STATUS FlashDrive_EraseFile(uint16_t volumeIndex, char *filename)
 	}
 	
 	//	rewrite the file key
+	FlashDrive_BumpVolumeRevision(volumeIndex);
 	key = FLASH_DRIVE_FILE_KEY_DELETED;
 	if (0 != Matrix.appInterface->flashWrite(volumeIndex, headerAddress, &key,
 		sizeof(((FLASH_DRIVE_FILE*)0)->key)))
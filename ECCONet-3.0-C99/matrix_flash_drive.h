@@ -355,6 +355,23 @@ extern FLASH_DRIVE_STATUS FlashDrive_ChangeFileSize(uint16_t volumeIndex, char *
   */
 extern uint16_t GetNumVolumes(void);
 
+/**
+  * @brief  Gets a volume's revision.
+	*					The revision changes whenever file headers are written or erased,
+	*					or file data is written or moved, so that cached header and data
+	*					locations and cached file data can be checked cheaply before use.
+	* @param  volumeIndex: Index of flash drive volume.
+  * @retval The volume revision.
+  */
+extern uint16_t FlashDrive_GetVolumeRevision(uint16_t volumeIndex);
+
+/**
+  * @brief  Changes a volume's revision.
+	* @param  volumeIndex: Index of flash drive volume.
+  * @retval None.
+  */
+extern void FlashDrive_BumpVolumeRevision(uint16_t volumeIndex);
+
 /**
   * @brief  Gets a volume's statistics.
 	* @param  volumeIndex: Index of flash drive volume to access.
@@ -89,6 +89,9 @@ FLASH_DRIVE_STATUS FlashDrive_CompactVolume(uint16_t volumeIndex)
 	if (volumeIndex >= GetNumVolumes())
 		return FDEC_INVALID_VOLUME_INDEX;
 	
+	//	files may move
+	FlashDrive_BumpVolumeRevision(volumeIndex);
+
 	//	volume params
 	volumeHeaderAddress = Matrix.appInterface->flashVolumes[volumeIndex].baseAddress;
 	volumeLastAddress = volumeHeaderAddress + Matrix.appInterface->flashVolumes[volumeIndex].size;
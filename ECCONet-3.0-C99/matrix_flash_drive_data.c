@@ -103,6 +103,9 @@ FLASH_DRIVE_STATUS FlashDrive_WriteFileData(uint16_t volumeIndex, char *filename
 	if (!wrap && ((dataLocationOffset + dataSize) > file.dataSize))
 		return FDEC_INPUT_NOT_VALID;
 	
+	//	the file data changes, so invalidate cached data
+	FlashDrive_BumpVolumeRevision(volumeIndex);
+	
 	//	write data
 	size = (file.dataSize >= (dataLocationOffset + dataSize)) ? dataSize : file.dataSize - dataLocationOffset;
 	if (0 != Matrix.appInterface->flashWrite(volumeIndex, file.dataLocation + dataLocationOffset,	data, size))
@@ -155,6 +158,9 @@ FLASH_DRIVE_STATUS FlashDrive_InsertFileData(uint16_t volumeIndex, char *filenam
 	if ((dataLocationOffset + dataSize) > header.dataSize)
 		return FDEC_NOT_ENOUGH_ROOM_IN_VOLUME;
 	
+	//	the file data changes, so invalidate cached data
+	FlashDrive_BumpVolumeRevision(volumeIndex);
+	
 	//	move previous data upward
 	if (0 != (status = FlashDrive_MoveFileData(volumeIndex, (uint8_t *)header.dataLocation + (dataLocationOffset + dataSize),
 		(uint8_t *)header.dataLocation + dataLocationOffset, header.dataSize - (dataLocationOffset + dataSize))))
@@ -205,6 +211,9 @@ FLASH_DRIVE_STATUS FlashDrive_RemoveFileData(uint16_t volumeIndex, char *filenam
 	if ((dataLocationOffset + dataSize) > header.dataSize)
 		return FDEC_NOT_ENOUGH_ROOM_IN_VOLUME;
 	
+	//	the file data changes, so invalidate cached data
+	FlashDrive_BumpVolumeRevision(volumeIndex);
+	
 	//	move previous data downward
 	if (0 != (status = FlashDrive_MoveFileData(volumeIndex, (uint8_t *)header.dataLocation + dataLocationOffset,
 		(uint8_t *)header.dataLocation + (dataLocationOffset + dataSize), header.dataSize - (dataLocationOffset + dataSize))))
@@ -387,6 +387,7 @@ FLASH_DRIVE_STATUS FlashDrive_WriteFileHeader(MATRIX_FILE_METADATA *file)
 			p_hdr->checksum = FlashDrive_ComputeHeaderCRC16(p_hdr);
 			hdr[sizeof(FLASH_DRIVE_FILE) + 0] = FLASH_DRIVE_FILE_ERASE_VALUE;
 			hdr[sizeof(FLASH_DRIVE_FILE) + 1] = FLASH_DRIVE_FILE_ERASE_VALUE;
+			FlashDrive_BumpVolumeRevision(file->volumeIndex);
 			if (0 == Matrix.appInterface->flashWrite(file->volumeIndex, volumeStats.NextHeaderAddress,
 				hdr, sizeof(FLASH_DRIVE_FILE) + 2))
 				return FDEC_OK;
@@ -47,6 +47,9 @@ FLASH_DRIVE_STATUS FlashDrive_ChangeFileSize(uint16_t volumeIndex, char *filenam
 	//	if file size is not changing, just return
 	if (0 == sizeChange)
 		return FDEC_OK;
+
+	//	files may move
+	FlashDrive_BumpVolumeRevision(volumeIndex);
 	
 	//	else if file is shrinking
 	if (0 > sizeChange)
@@ -21,6 +21,9 @@
 #include "matrix_lib_interface.h"
 
 
+//	the volume revisions
+static uint16_t volumeRevisions[MATRIX_FLASH_DRIVE_MAX_NUM_VOLUMES];
+
 
 /**
   * @brief  Gets the number of available flash drive volumes.
@@ -41,6 +44,32 @@ uint16_t GetNumVolumes(void)
 	return 0;
 }
 
+/**
+  * @brief  Gets a volume's revision.
+	*					The revision changes whenever file headers are written or erased,
+	*					or file data is written or moved, so that cached header and data
+	*					locations and cached file data can be checked cheaply before use.
+	* @param  volumeIndex: Index of flash drive volume.
+  * @retval The volume revision.
+  */
+uint16_t FlashDrive_GetVolumeRevision(uint16_t volumeIndex)
+{
+	if (volumeIndex < MATRIX_FLASH_DRIVE_MAX_NUM_VOLUMES)
+		return volumeRevisions[volumeIndex];
+	return 0;
+}
+
+/**
+  * @brief  Changes a volume's revision.
+	* @param  volumeIndex: Index of flash drive volume.
+  * @retval None.
+  */
+void FlashDrive_BumpVolumeRevision(uint16_t volumeIndex)
+{
+	if (volumeIndex < MATRIX_FLASH_DRIVE_MAX_NUM_VOLUMES)
+		++volumeRevisions[volumeIndex];
+}
+
 /**
   * @brief  Gets a volume's statistics.
 	* @param  volumeIndex: Index of flash drive volume to access.
@@ -31,6 +31,8 @@
 extern MATRIX_FTP_SERVER_OBJECT MatrixFTPServer;
 extern int Matrix_PrivateSendCanToken(TOKEN *token);
 extern uint32_t GenerateServerAccessCode(uint32_t guid[4]);
+static void StartSegmentLength(uint16_t requestedSegmentLength);
+static int SetNegotiatedSegmentLength(uint16_t segmentLength);
 static void FinishRequest(uint16_t expectedResponse);
 static void EndTransaction(uint16_t key);
 static void PopulateCallbackInfo(FTP_CLIENT_CALLBACK_INFO *callbackInfo, uint16_t responseKey);
@@ -48,6 +50,10 @@ static void HandleFileWriteSegmentResponse(uint8_t *body, uint32_t bodySize);
 //	delete file
 static void HandleFileDeleteResponse(uint8_t *body, uint32_t bodySize);
 
+//	volume directory
+static void RequestDirectoryPage(void);
+static void HandleFileDirectoryResponse(uint8_t *body, uint32_t bodySize);
+
 
 /**
   * @brief  The Matrix ftp client data object.
@@ -64,6 +70,7 @@ void MatrixFTPClient_Reset(void)
 	//	reset the file transfer state
 	MatrixFTPClient.requester.callback = NULL;
 	MatrixFTPClient.server.expectedResponse = KeyNull;
+	MatrixFTPClient.file.segmentLength = MATRIX_MAX_FILE_SEGMENT_LENGTH;
 
 	//	start request timeout timer
 	MatrixFTPClient.server.responseTimeout =
@@ -89,6 +96,8 @@ void MatrixFTPClient_Clock(void)
 		
 		if (KeyNull != MatrixFTPClient.server.expectedResponse)
 		{
+			++MatrixFTPClient.stats.numTimeouts;
+
 			//	if callback then notify requester
 			if (NULL != MatrixFTPClient.requester.callback)
 			{
@@ -120,6 +129,9 @@ void MatrixFTPClient_ServerResponseIn(uint16_t senderAddress, uint16_t responseK
 		|| (senderAddress != MatrixFTPClient.server.address))
 		return;
 
+	//	add the time waiting for the response
+	MatrixFTPClient.stats.busTime += (Matrix.systemTime - MatrixFTPClient.server.requestTime);
+
 	//	if response is not the expected response, then end transaction
 	if (responseKey != MatrixFTPClient.server.expectedResponse)
 	{
@@ -152,6 +164,10 @@ void MatrixFTPClient_ServerResponseIn(uint16_t senderAddress, uint16_t responseK
 			HandleFileDeleteResponse(body, bodySize);
 			break;
 
+		case KeyResponseFileDirectory:
+			HandleFileDirectoryResponse(body, bodySize);
+			break;
+
 		//	any other response ends transaction
 		default:
 			EndTransaction(responseKey);
@@ -186,6 +202,9 @@ int MatrixFTPClient_GetIndexedFileInfo(FTP_CLIENT_FILE_TRANSFER_PARAMS *transfer
 	MatrixFTPClient.requester.bufferSize = 0;
 	MatrixFTPClient.requester.callback = transferParams->callback;
 	MatrixFTPClient.file.name[0] = 0;
+	MatrixFTPClient.file.dataOffset = 0;
+	memset(&MatrixFTPClient.stats, 0, sizeof(FTP_TRANSFER_STATS));
+	MatrixFTPClient.file.resumeOffset = 0;
 	
 	//	initialize the transmitter
 	MatrixTransmitter_StartMessage(transferParams->serverAddress);
@@ -239,6 +258,9 @@ int MatrixFTPClient_GetFileInfo(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams)
 	MatrixFTPClient.requester.bufferSize = 0;
 	MatrixFTPClient.requester.callback = transferParams->callback;
 	strcpy(MatrixFTPClient.file.name, transferParams->filename);
+	MatrixFTPClient.file.dataOffset = 0;
+	memset(&MatrixFTPClient.stats, 0, sizeof(FTP_TRANSFER_STATS));
+	MatrixFTPClient.file.resumeOffset = 0;
 	
 	//	initialize the transmitter
 	MatrixTransmitter_StartMessage(transferParams->serverAddress);
@@ -289,6 +311,15 @@ int MatrixFTPClient_ReadFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams)
 	MatrixFTPClient.requester.bufferSize = transferParams->bufferSize;
 	MatrixFTPClient.requester.callback = transferParams->callback;
 	strcpy(MatrixFTPClient.file.name, transferParams->filename);
+	MatrixFTPClient.file.dataOffset = 0;
+	memset(&MatrixFTPClient.stats, 0, sizeof(FTP_TRANSFER_STATS));
+	
+	StartSegmentLength(transferParams->segmentLength);
+	
+	//	save the resume parameters, which are checked against the server file info
+	MatrixFTPClient.file.resumeOffset = transferParams->resumeOffset;
+	MatrixFTPClient.file.resumeTimestamp = transferParams->fileTimestamp;
+	MatrixFTPClient.file.resumeDataChecksum = transferParams->fileDataChecksum;
 	
 	//	initialize the transmitter
 	MatrixTransmitter_StartMessage(transferParams->serverAddress);
@@ -302,6 +333,10 @@ int MatrixFTPClient_ReadFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams)
 	//	send the server access code
 	MatrixTransmitter_AddInt32(transferParams->serverAccessCode);
 
+	//	if negotiating, send the requested segment length
+	if (0 != MatrixFTPClient.file.requestedSegmentLength)
+		MatrixTransmitter_AddInt16(MatrixFTPClient.file.requestedSegmentLength);
+
 	//	send the request
 	FinishRequest(KeyResponseFileReadStart);
 	return 0;
@@ -340,6 +375,14 @@ int MatrixFTPClient_WriteFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams)
 	MatrixFTPClient.requester.callback = transferParams->callback;
 	strcpy(MatrixFTPClient.file.name, transferParams->filename);
 	MatrixFTPClient.file.dataSize = transferParams->bufferSize;
+	MatrixFTPClient.file.dataOffset = 0;
+	memset(&MatrixFTPClient.stats, 0, sizeof(FTP_TRANSFER_STATS));
+	StartSegmentLength(transferParams->segmentLength);
+
+	//	a write resumes on a segment boundary within the file
+	MatrixFTPClient.file.resumeOffset = (transferParams->resumeOffset < transferParams->bufferSize) ?
+		(transferParams->resumeOffset & ~(uint32_t)(MAX(MatrixFTPClient.file.requestedSegmentLength,
+		MATRIX_MAX_FILE_SEGMENT_LENGTH) - 1)) : 0;
 
 	//	initialize the transmitter
 	MatrixTransmitter_StartMessage(transferParams->serverAddress);
@@ -362,6 +405,14 @@ int MatrixFTPClient_WriteFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams)
 	//	send the server access code
 	MatrixTransmitter_AddInt32(transferParams->serverAccessCode);
 
+	//	if resuming or negotiating the segment length, send the resume offset
+	if ((0 != MatrixFTPClient.file.resumeOffset) || (0 != MatrixFTPClient.file.requestedSegmentLength))
+		MatrixTransmitter_AddInt32(MatrixFTPClient.file.resumeOffset);
+
+	//	if negotiating, send the requested segment length
+	if (0 != MatrixFTPClient.file.requestedSegmentLength)
+		MatrixTransmitter_AddInt16(MatrixFTPClient.file.requestedSegmentLength);
+
 	//	send the request
 	FinishRequest(KeyResponseFileWriteStart);
 	return 0;
@@ -399,6 +450,9 @@ int MatrixFTPClient_DeleteFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams)
 	MatrixFTPClient.requester.bufferSize = 0;
 	MatrixFTPClient.requester.callback = transferParams->callback;
 	strcpy(MatrixFTPClient.file.name, transferParams->filename);
+	MatrixFTPClient.file.dataOffset = 0;
+	memset(&MatrixFTPClient.stats, 0, sizeof(FTP_TRANSFER_STATS));
+	MatrixFTPClient.file.resumeOffset = 0;
 	
 	//	initialize the transmitter
 	MatrixTransmitter_StartMessage(transferParams->serverAddress);
@@ -417,6 +471,73 @@ int MatrixFTPClient_DeleteFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams)
 	return 0;
 }
 
+/**
+  * @brief  Starts a volume directory request from the given Matrix ftp server.
+	* @param  transferParams: A pointer to a file transfer parameter structure.
+  * @retval Returns 0 on success, else -1.
+  */
+int MatrixFTPClient_GetDirectory(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams)
+{
+	//	if this device is currently acting as a server,
+	//	then reject this request
+	if (KeyNull != MatrixFTPServer.client.request)
+		return -1;
+	
+	//	if tranfer already in progress, then return
+	if (KeyNull != MatrixFTPClient.server.expectedResponse)
+		return -1;
+	
+	//	validate inputs
+	if ((NULL == transferParams) || (0 == transferParams->serverAddress)
+		|| (NULL == transferParams->buffer)
+		|| (sizeof(FTP_CLIENT_DIRECTORY_ENTRY) > transferParams->bufferSize))
+		return -1;
+	
+	//	copy the requestor parameters
+  MatrixFTPClient.server.address = transferParams->serverAddress;
+  MatrixFTPClient.server.accessCode = transferParams->serverAccessCode;
+	MatrixFTPClient.requester.buffer = transferParams->buffer;
+	MatrixFTPClient.requester.bufferSize = transferParams->bufferSize;
+	MatrixFTPClient.requester.callback = transferParams->callback;
+	MatrixFTPClient.file.name[0] = 0;
+	MatrixFTPClient.file.dataSize = 0;
+	MatrixFTPClient.file.dataOffset = 0;
+	memset(&MatrixFTPClient.stats, 0, sizeof(FTP_TRANSFER_STATS));
+	MatrixFTPClient.file.resumeOffset = 0;
+	MatrixFTPClient.file.volumeIndex = transferParams->volumeIndex;
+	MatrixFTPClient.file.fileIndex = transferParams->fileIndex;
+	
+	//	request the first page
+	RequestDirectoryPage();
+	return 0;
+}
+
+
+/**
+  * @brief  Finds whether a file differs from a directory or manifest listing.
+	* @param  file: A pointer to a directory entry for the file to check.
+	* @param  listing: A pointer to the directory or manifest entries.
+	* @param  numEntries: The number of entries in the listing.
+  * @retval Returns true if the file differs from the listing.
+  */
+bool MatrixFTPClient_IsFileChanged(const FTP_CLIENT_DIRECTORY_ENTRY *file,
+	const FTP_CLIENT_DIRECTORY_ENTRY *listing, uint32_t numEntries)
+{
+	//	validate inputs
+	if ((NULL == file) || (NULL == listing))
+		return true;
+
+	//	find the file by volume and name, and compare its metadata
+	while (numEntries--)
+	{
+		if ((listing->volumeIndex == file->volumeIndex) && (0 == strcmp(listing->filename, file->filename)))
+			return ((listing->fileDataSize != file->fileDataSize) || (listing->fileDate != file->fileDate)
+				|| (listing->fileDataChecksum != file->fileDataChecksum));
+		++listing;
+	}
+	return true;
+}
+
 
 //	private methods........................................................
 
@@ -436,11 +557,12 @@ static void FinishRequest(uint16_t expectedResponse)
 	{
     //  set the expected response and start the response timer
 		MatrixFTPClient.server.expectedResponse = expectedResponse;
+		MatrixFTPClient.server.requestTime = Matrix.systemTime;
 		MatrixFTPClient.server.responseTimeout =
 			Matrix.systemTime + MATRIX_MAX_FILE_REQUEST_RESPONSE_TIME_MS;
 
-		//	set the receiver sender address filter
-		MatrixReceiver_SetSenderAddressFilter(MatrixFTPClient.server.address);
+		//	set the receiver session address
+		MatrixReceiver_SetSessionAddress(MatrixFTPClient.server.address);
 	}
 	else
 	{
@@ -474,6 +596,40 @@ static void PopulateCallbackInfo(FTP_CLIENT_CALLBACK_INFO *callbackInfo, uint16_
 	callbackInfo->fileDate = MatrixFTPClient.file.date;
 	callbackInfo->fileDataSize = MatrixFTPClient.file.dataSize;
 	callbackInfo->fileDataChecksum = MatrixFTPClient.file.dataChecksum;
+	callbackInfo->fileDataOffset = MatrixFTPClient.file.dataOffset;
+
+	//	statistics
+	callbackInfo->stats = MatrixFTPClient.stats;
+}
+
+/**
+	* @brief  Helper method starts a transfer with the default segment length,
+	*					and sets the segment length to request, if any.
+	* @param  requestedSegmentLength: The caller's requested segment length, or zero for the default.
+  * @retval None.
+  */
+static void StartSegmentLength(uint16_t requestedSegmentLength)
+{
+	MatrixFTPClient.file.segmentLength = MATRIX_MAX_FILE_SEGMENT_LENGTH;
+	MatrixFTPClient.file.requestedSegmentLength = 0;
+	if ((0 != requestedSegmentLength) && (MATRIX_MAX_FILE_SEGMENT_LENGTH != requestedSegmentLength))
+		MatrixFTPClient.file.requestedSegmentLength =
+			MatrixFTPServer_LimitFileSegmentLength(requestedSegmentLength);
+}
+
+/**
+	* @brief  Helper method validates and sets the segment length given by the server.
+	* @param  segmentLength: The server segment length.
+  * @retval Returns 0 if the segment length is valid, else -1.
+  */
+static int SetNegotiatedSegmentLength(uint16_t segmentLength)
+{
+	//	must be a power of two no larger than requested
+	if ((0 == segmentLength) || (0 != (segmentLength & (segmentLength - 1)))
+		|| (segmentLength > MatrixFTPClient.file.requestedSegmentLength))
+		return -1;
+	MatrixFTPClient.file.segmentLength = segmentLength;
+	return 0;
 }
 
 /**
@@ -491,9 +647,9 @@ static void EndTransaction(uint16_t responseKey)
 	FTP_CLIENT_CALLBACK_INFO info;
 	TOKEN token;
 	
-	//	clear expected response and receiver sender address filter
+	//	clear expected response and receiver session address
 	MatrixFTPClient.server.expectedResponse = KeyNull;
-	MatrixReceiver_SetSenderAddressFilter(0);
+	MatrixReceiver_SetSessionAddress(0);
 	
 	//	let the server know that transaction is complete
 	token.address = MatrixFTPClient.server.address;
@@ -534,6 +690,7 @@ static void RequestReadSegment(void)
 
 	//	send the segment index
 	MatrixTransmitter_AddInt16((uint32_t)MatrixFTPClient.file.segmentIndex);
+	++MatrixFTPClient.stats.numSegments;
 	
 	//	send the server access code
 	MatrixTransmitter_AddInt32(MatrixFTPClient.server.accessCode);
@@ -605,6 +762,18 @@ static void HandleFileInfoAndReadStartResponse(uint16_t response,
 		MatrixFTPClient.file.date |= *body++;
 	}
 	
+	//	if a read start and the segment length was negotiated, then use the server's segment length
+	if ((KeyResponseFileReadStart == response) && (0 != MatrixFTPClient.file.requestedSegmentLength)
+		&& (bodySize >= (uint32_t)(filenameLen + (1 + 4 + 2 + 4 + 2))))
+	{
+		if (0 != SetNegotiatedSegmentLength(((uint16_t)body[0] << 8) | body[1]))
+		{
+			EndTransaction(KeyResponseFtpServerError);
+			return;
+		}
+		body += 2;
+	}
+	
 	//	if this was a product info file info request, and body has 16 additional guid bytes
 	if ((KeyResponseFileInfo == response)
 		&& (0 == strcmp(MatrixFTPClient.file.name, MATRIX_PRODUCT_INFO_FILE_NAME))
@@ -638,8 +807,21 @@ static void HandleFileInfoAndReadStartResponse(uint16_t response,
 		return;
 	}
 
-	//	clear number of bytes transferred and make first segment request
-	MatrixFTPClient.file.segmentIndex = 0;
+	//	if resuming a read of the same file, then continue from the last whole segment,
+	//	else clear number of bytes transferred
+	if ((0 != MatrixFTPClient.file.resumeOffset)
+		&& (MatrixFTPClient.file.resumeOffset < MatrixFTPClient.file.dataSize)
+		&& (MatrixFTPClient.file.resumeOffset < (uint32_t)MatrixFTPClient.requester.bufferSize)
+		&& (MatrixFTPClient.file.resumeTimestamp == MatrixFTPClient.file.date)
+		&& (MatrixFTPClient.file.resumeDataChecksum == MatrixFTPClient.file.dataChecksum))
+		MatrixFTPClient.file.segmentIndex = (int32_t)(MatrixFTPClient.file.resumeOffset
+			/ MatrixFTPClient.file.segmentLength);
+	else
+		MatrixFTPClient.file.segmentIndex = 0;
+	MatrixFTPClient.file.dataOffset = (uint32_t)MatrixFTPClient.file.segmentIndex
+		* MatrixFTPClient.file.segmentLength;
+	
+	//	make the first segment request
 	RequestReadSegment();
 }
 
@@ -671,13 +853,17 @@ static void HandleFileReadSegmentResponse(uint8_t *body, uint32_t bodySize)
 	}
 	
   //  get least of file bytes and requester buffer bytes remaining
-  dataIndex = (int32_t)(MatrixFTPClient.file.segmentIndex * MATRIX_MAX_FILE_SEGMENT_LENGTH);
+  dataIndex = (int32_t)(MatrixFTPClient.file.segmentIndex * MatrixFTPClient.file.segmentLength);
   numCopyBytes = (int32_t)MIN(bodySize - 2, MatrixFTPClient.file.dataSize - dataIndex);
   numCopyBytes = (int32_t)MIN(numCopyBytes, MatrixFTPClient.requester.bufferSize - dataIndex);	
 	
-	//	copy bytes to requested buffer
+	//	copy bytes to requested buffer at the segment location
 	if (0 < numCopyBytes)
-		memcpy(MatrixFTPClient.requester.buffer, body, numCopyBytes);
+	{
+		memcpy(MatrixFTPClient.requester.buffer + dataIndex, body, numCopyBytes);
+		dataIndex += numCopyBytes;
+		MatrixFTPClient.file.dataOffset = (uint32_t)dataIndex;
+	}
 	
 	//	if whole file transferred or requestor buffer full, then done
 	if ((0 >= (MatrixFTPClient.file.dataSize - dataIndex))
@@ -717,9 +903,9 @@ static void RequestWriteSegment(void)
   int32_t dataIndex, numCopyBytes;
 	
 	//	get the bytes remaining to write
-	dataIndex = (int32_t)(MatrixFTPClient.file.segmentIndex * MATRIX_MAX_FILE_SEGMENT_LENGTH);
+	dataIndex = (int32_t)(MatrixFTPClient.file.segmentIndex * MatrixFTPClient.file.segmentLength);
 	numCopyBytes = (int32_t)MIN(MatrixFTPClient.file.dataSize - dataIndex,
-		MATRIX_MAX_FILE_SEGMENT_LENGTH);
+		MatrixFTPClient.file.segmentLength);
 	if (0 >= numCopyBytes)
 	{
 		EndTransaction(KeyResponseFileWriteComplete);
@@ -734,6 +920,7 @@ static void RequestWriteSegment(void)
 
 	//	send the segment index
 	MatrixTransmitter_AddInt16(MatrixFTPClient.file.segmentIndex);
+	++MatrixFTPClient.stats.numSegments;
 	
 	//	send the access code
 	MatrixTransmitter_AddInt32(MatrixFTPClient.server.accessCode);
@@ -754,7 +941,8 @@ static void RequestWriteSegment(void)
   */
 static void HandleFileWriteStartResponse(uint8_t *body, uint32_t bodySize)
 {
-	uint16_t filenameLen;
+	uint16_t filenameLen, i;
+	uint32_t resumeOffset;
 
 	//  server must provide valid file name
 	filenameLen = FlashDrive_ValidateFileName((char *)body);
@@ -771,8 +959,39 @@ static void HandleFileWriteStartResponse(uint8_t *body, uint32_t bodySize)
 		return;
 	}
 	
-	//	clear number of bytes transferred and write the first segment
+	//	get the accepted resume offset, if any
+	resumeOffset = 0;
+	body += (filenameLen + 1);
+	if (bodySize >= (uint32_t)(filenameLen + (1 + 4)))
+	{
+		i = 4;
+		while (i--)
+		{
+			resumeOffset <<= 8;
+			resumeOffset |= *body++;
+		}
+	}
+	
+	//	if the segment length was negotiated, then use the server's segment length
+	if ((0 != MatrixFTPClient.file.requestedSegmentLength)
+		&& (bodySize >= (uint32_t)(filenameLen + (1 + 4 + 2))))
+	{
+		if (0 != SetNegotiatedSegmentLength(((uint16_t)body[0] << 8) | body[1]))
+		{
+			EndTransaction(KeyResponseFtpServerError);
+			return;
+		}
+	}
+	
+	//	if the server accepted the requested resume offset, then continue from there,
+	//	else clear number of bytes transferred
 	MatrixFTPClient.file.segmentIndex = 0;
+	if ((0 != MatrixFTPClient.file.resumeOffset) && (resumeOffset == MatrixFTPClient.file.resumeOffset))
+		MatrixFTPClient.file.segmentIndex = (int32_t)(resumeOffset / MatrixFTPClient.file.segmentLength);
+	MatrixFTPClient.file.dataOffset = (uint32_t)MatrixFTPClient.file.segmentIndex
+		* MatrixFTPClient.file.segmentLength;
+
+	//	write the first segment
 	RequestWriteSegment();
 }
 
@@ -802,6 +1021,10 @@ static void HandleFileWriteSegmentResponse(uint8_t *body, uint32_t bodySize)
 		return;
 	}
 
+	//	update the number of bytes confirmed written
+	MatrixFTPClient.file.dataOffset = MIN(MatrixFTPClient.file.dataSize,
+		((uint32_t)(segmentIndex + 1) * MatrixFTPClient.file.segmentLength));
+
 	//	write the next segment
 	++MatrixFTPClient.file.segmentIndex;
 	RequestWriteSegment();
@@ -835,3 +1058,148 @@ static void HandleFileDeleteResponse(uint8_t *body, uint32_t bodySize)
 	//	end transaction
 	EndTransaction(KeyResponseFileDeleteComplete);
 }
+
+
+/////////////////////////////////////////////////////////////////////////////
+//
+//	READ VOLUME DIRECTORY FROM SERVER
+
+/**
+  * @brief  Requests a page of the volume directory from the next file index.
+	* @param  None.
+  * @retval None.
+  */
+static void RequestDirectoryPage(void)
+{
+	//	initialize the transmitter
+	MatrixTransmitter_StartMessage(MatrixFTPClient.server.address);
+
+	//	send the request key
+	MatrixTransmitter_AddInt16(KeyRequestFileDirectory);
+
+	//	send the drive volume index
+	MatrixTransmitter_AddInt16(MatrixFTPClient.file.volumeIndex);
+
+	//	send the start file index
+	MatrixTransmitter_AddInt32(MatrixFTPClient.file.fileIndex);
+
+	//	send the server access code
+	MatrixTransmitter_AddInt32(MatrixFTPClient.server.accessCode);
+	
+	//	send request
+	FinishRequest(KeyResponseFileDirectory);
+}
+
+/**
+  * @brief  Handles a volume directory page server response.
+	*					The file records are added to the requester buffer as directory entries,
+	*					and the file data size counts the entries received.
+	* @param  body: A pointer to the message body.
+	* @param  bodySize: The message body size in bytes.
+  * @retval None.
+  */
+static void HandleFileDirectoryResponse(uint8_t *body, uint32_t bodySize)
+{
+	FTP_CLIENT_DIRECTORY_ENTRY *entry;
+	uint16_t i, volumeIndex, filenameLen, numRecords, recordVolumeSize;
+	uint32_t startIndex, maxEntries;
+	bool isManifest;
+
+	//	server response must include the volume index, start index and last page flag
+	if ((NULL == body) || ((2 + 4 + 1) > bodySize))
+	{
+		EndTransaction(KeyResponseFtpServerError);
+		return;
+	}
+
+	//	server response must match the requested volume and start index
+	volumeIndex = *body++;
+	volumeIndex = (volumeIndex << 8) | *body++;
+	i = 4;
+	startIndex = 0;
+	while (i--)
+	{
+		startIndex <<= 8;
+		startIndex |= *body++;
+	}
+	bodySize -= (2 + 4);
+	if ((volumeIndex != MatrixFTPClient.file.volumeIndex) || (startIndex != MatrixFTPClient.file.fileIndex))
+	{
+		EndTransaction(KeyResponseFtpServerError);
+		return;
+	}
+
+	//	manifest records start with the file volume index
+	isManifest = (FTP_MANIFEST_VOLUME_INDEX == volumeIndex);
+	recordVolumeSize = isManifest ? 2 : 0;
+
+	//	while file records before the last page flag
+	maxEntries = (uint32_t)MatrixFTPClient.requester.bufferSize / sizeof(FTP_CLIENT_DIRECTORY_ENTRY);
+	numRecords = 0;
+	while ((1 < bodySize) && (MatrixFTPClient.file.dataSize < maxEntries))
+	{
+		//	server must provide a valid file name and the record fields
+		filenameLen = (bodySize > recordVolumeSize) ?
+			FlashDrive_ValidateFileName((char *)body + recordVolumeSize) : 0;
+		if ((0 == filenameLen)
+			|| (bodySize < (uint32_t)(recordVolumeSize + filenameLen + (1 + 4 + 2 + 4 + 1))))
+		{
+			EndTransaction(KeyResponseFtpServerError);
+			return;
+		}
+
+		//	add the directory entry
+		entry = (FTP_CLIENT_DIRECTORY_ENTRY *)MatrixFTPClient.requester.buffer
+			+ MatrixFTPClient.file.dataSize;
+		entry->volumeIndex = volumeIndex;
+		if (isManifest)
+		{
+			entry->volumeIndex = *body++;
+			entry->volumeIndex = (entry->volumeIndex << 8) | *body++;
+		}
+		strcpy(entry->filename, (char *)body);
+		body += (filenameLen + 1);
+		i = 4;
+		entry->fileDataSize = 0;
+		while (i--)
+		{
+			entry->fileDataSize <<= 8;
+			entry->fileDataSize |= *body++;
+		}
+		i = 2;
+		entry->fileDataChecksum = 0;
+		while (i--)
+		{
+			entry->fileDataChecksum <<= 8;
+			entry->fileDataChecksum |= *body++;
+		}
+		i = 4;
+		entry->fileDate = 0;
+		while (i--)
+		{
+			entry->fileDate <<= 8;
+			entry->fileDate |= *body++;
+		}
+		bodySize -= (recordVolumeSize + filenameLen + (1 + 4 + 2 + 4));
+		++MatrixFTPClient.file.dataSize;
+		++numRecords;
+	}
+	MatrixFTPClient.file.fileIndex += numRecords;
+
+	//	if the last page or the requester buffer is full, then done
+	if (((1 == bodySize) && (0 != *body)) || (MatrixFTPClient.file.dataSize >= maxEntries))
+	{
+		EndTransaction(KeyResponseFtpTransactionComplete);
+		return;
+	}
+
+	//	a page that is not the last must make progress
+	if (0 == numRecords)
+	{
+		EndTransaction(KeyResponseFtpServerError);
+		return;
+	}
+
+	//	request the next page
+	RequestDirectoryPage();
+}
@@ -46,6 +46,9 @@ typedef struct
 	//	the server timeout
 	uint32_t responseTimeout;
 	
+	//	the time that the last request was sent
+	uint32_t requestTime;
+	
 } MFTP_SERVER;
 
 /**
@@ -64,7 +67,25 @@ typedef struct
 	
 	//	the number of bytes transferred
 	int32_t segmentIndex;
-	
+
+	//	the number of data bytes confirmed transferred
+	uint32_t dataOffset;
+
+	//	the segment length, and the segment length requested from the server
+	uint16_t segmentLength;
+	uint16_t requestedSegmentLength;
+
+	//	the requested resume offset, or zero if starting from the beginning
+	uint32_t resumeOffset;
+
+	//	the expected timestamp and data checksum when resuming a read
+	uint32_t resumeTimestamp;
+	uint16_t resumeDataChecksum;
+
+	//	the directory volume index, and the next directory file index to request
+	uint16_t volumeIndex;
+	uint32_t fileIndex;
+
 	//	the file name
 	char name[MATRIX_FILE_NAME_LENGTH + 1];
 	
@@ -100,6 +121,9 @@ typedef struct
 	//	the file information
 	MFTP_CLIENT_FILE file;
 	
+	//	the transaction statistics
+	FTP_TRANSFER_STATS stats;
+	
 
 } MATRIX_FTP_CLIENT_OBJECT;
 //	private extern MATRIX_FTP_CLIENT_OBJECT MatrixFTPClient;
@@ -24,8 +24,34 @@
 #include <stdbool.h>
 
 
+//	the directory volume index that requests the manifest of all volumes
+#define FTP_MANIFEST_VOLUME_INDEX		0xFFFF
 
 
+
+/**
+  * @brief  The ftp transfer statistics structure.
+	*					Times are in milliseconds.
+  */	
+typedef struct
+{
+	//	the number of file segments transferred
+	uint32_t numSegments;
+	
+	//	the number of file segments transferred again, server only
+	uint32_t numRetransmits;
+	
+	//	the number of requests that timed out
+	uint32_t numTimeouts;
+	
+	//	the time spent waiting on the bus for the other device
+	uint32_t busTime;
+	
+	//	the time spent reading and writing flash, server only
+	uint32_t flashTime;
+	
+} FTP_TRANSFER_STATS;
+
 /**
   * @brief  The ftp client transfer complete callback structure.
   * @retval None.
@@ -45,7 +71,14 @@ typedef struct
 	uint32_t fileDataSize;
 	uint16_t fileDataChecksum;
 	char filename[MATRIX_FILE_NAME_LENGTH + 1];
-	
+
+	//	the number of file data bytes confirmed transferred,
+	//	which may be given as the resume offset to continue an interrupted transfer
+	uint32_t fileDataOffset;
+
+	//	the transaction statistics
+	FTP_TRANSFER_STATS stats;
+
 } FTP_CLIENT_CALLBACK_INFO;
 
 /**
@@ -70,15 +103,28 @@ typedef struct
 	//	a pointer to the file name
 	char *filename;
 
-	//	the volume index, only used for indexed file info
+	//	the volume index, only used for indexed file info and directory listing
 	uint16_t volumeIndex;
 	
-	//	the file index, only used for indexed file info
+	//	the file index, only used for indexed file info and directory listing
 	uint32_t fileIndex;
 	
 	//	the file timestamp
 	uint32_t fileTimestamp;
-	
+
+	//	the file data checksum, only used to resume a file read
+	uint16_t fileDataChecksum;
+
+	//	the data offset from which to resume an interrupted file read or write,
+	//	as reported in the callback info fileDataOffset, else zero to start from the beginning
+	//	a read resumes only if the server file timestamp and checksum match those given here
+	//	a write resumes only if the server holds a pending copy of the same file
+	uint32_t resumeOffset;
+
+	//	the requested segment length for a file read or write, or zero for the default
+	//	the server may reduce this to fit its buffers, and resumes use the reduced length
+	uint16_t segmentLength;
+
 	//	a pointer to a data buffer
 	//	for a file write, this buffer gives the file data
 	//	for a file read, this buffer receives the file data
@@ -95,6 +141,24 @@ typedef struct
 } FTP_CLIENT_FILE_TRANSFER_PARAMS;
 
 
+/**
+  * @brief  The ftp client directory entry structure.
+	*					A directory request fills the caller's buffer with an array of these.
+  */	
+typedef struct
+{
+	//	file info
+	char filename[MATRIX_FILE_NAME_LENGTH + 1];
+	uint32_t fileDate;
+	uint32_t fileDataSize;
+	uint16_t fileDataChecksum;
+
+	//	the file volume index
+	uint16_t volumeIndex;
+
+} FTP_CLIENT_DIRECTORY_ENTRY;
+
+
 /**
   * @brief  Starts an indexed file info request from the given Matrix ftp server.
 	* @param  transferParams: A pointer to a file transfer parameter structure.
@@ -123,6 +187,30 @@ extern int MatrixFTPClient_ReadFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferPar
   */
 extern int MatrixFTPClient_WriteFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams);
 
+/**
+  * @brief  Starts a volume directory request from the given Matrix ftp server.
+	*					The volume index gives the volume, or FTP_MANIFEST_VOLUME_INDEX for the manifest
+	*					of all volumes, and the file index gives the first file to list.
+	*					The buffer receives an array of directory entries, and the callback info
+	*					file data size gives the number of entries received.
+	*					If the buffer fills first, the caller may continue from the next file index.
+	* @param  transferParams: A pointer to a file transfer parameter structure.
+  * @retval Returns 0 on success, else -1.
+  */
+extern int MatrixFTPClient_GetDirectory(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams);
+
+/**
+  * @brief  Finds whether a file differs from a directory or manifest listing,
+	*					such that the file is missing from the listing, or has a different
+	*					size, timestamp or data checksum.
+	* @param  file: A pointer to a directory entry for the file to check.
+	* @param  listing: A pointer to the directory or manifest entries.
+	* @param  numEntries: The number of entries in the listing.
+  * @retval Returns true if the file differs from the listing.
+  */
+extern bool MatrixFTPClient_IsFileChanged(const FTP_CLIENT_DIRECTORY_ENTRY *file,
+	const FTP_CLIENT_DIRECTORY_ENTRY *listing, uint32_t numEntries);
+
 /**
   * @brief  Deletes a file from the given Matrix ftp server.
 	* @param  transferParams: A pointer to a file transfer parameter structure.
@@ -130,6 +218,13 @@ extern int MatrixFTPClient_WriteFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferPa
   */
 extern int MatrixFTPClient_DeleteFile(FTP_CLIENT_FILE_TRANSFER_PARAMS *transferParams);
 
+/**
+  * @brief  Gets the statistics of the current or last file read or write on this ftp server.
+	* @param  stats: A pointer to a statistics structure to receive the statistics.
+  * @retval None.
+  */
+extern void MatrixFTPServer_GetStats(FTP_TRANSFER_STATS *stats);
+
 
 
 #endif  //  __MATRIX_LIB_INTERFACE_H
@@ -47,10 +47,27 @@ static void HandleFileReadSegmentRequest(uint8_t *body, uint32_t bodySize);
 static void HandleFileWriteStartRequest(uint16_t senderAddress,
 	uint8_t *body, uint32_t bodySize);
 static void HandleFileWriteSegmentRequest(uint8_t *body, uint32_t bodySize);
+static bool CanResumeFileWrite(uint32_t resumeOffset);
+
+//	open file handle
+static int OpenFileHandle(void);
+static int ValidateFileHandle(void);
+
+//	read-ahead
+#ifdef MATRIX_FTP_SERVER_READ_AHEAD
+static void ReadAheadSegment(void);
+#endif
+
+//	statistics
+static uint32_t GetFlashTime(void);
+static void CountSegment(uint16_t segmentIndex);
 
 //	request to erase file
 static void HandleFileEraseRequest(uint8_t *body, uint32_t bodySize);
 
+//	request for volume directory
+static void HandleFileDirectoryRequest(uint8_t *body, uint32_t bodySize);
+
 
 /**
   * @brief  The Matrix file transfer data object.
@@ -67,8 +84,15 @@ void MatrixFTPServer_Reset(void)
 {
 	uint32_t guid[4];
 
-	//	reset the client request
+	//	reset the client request, file handle and segment length
 	MatrixFTPServer.client.request = KeyNull;
+	MatrixFTPServer.handle.isOpen = false;
+	MatrixFTPServer.segmentLength = MATRIX_MAX_FILE_SEGMENT_LENGTH;
+#ifdef MATRIX_FTP_SERVER_READ_AHEAD
+	MatrixFTPServer.readAhead.isPending = false;
+	MatrixFTPServer.readAhead.isValid = false;
+#endif
+	memset(&MatrixFTPServer.stats, 0, sizeof(FTP_TRANSFER_STATS));
 	
 	//	set the server access code
 	if ((NULL != Matrix.appInterface) && (NULL != Matrix.appInterface->get128BitGuid))
@@ -99,8 +123,27 @@ void MatrixFTPServer_Clock(void)
 			Matrix.systemTime + MATRIX_MAX_FILE_REQUEST_RESPONSE_TIME_MS;
 		
 		//	clear any client request
+		if (KeyNull != MatrixFTPServer.client.request)
+			++MatrixFTPServer.stats.numTimeouts;
 		MatrixFTPServer.client.request = KeyNull;
 	}
+	
+#ifdef MATRIX_FTP_SERVER_READ_AHEAD
+	//	if a segment read-ahead is pending, then read it while the client processes the last one
+	if (MatrixFTPServer.readAhead.isPending)
+		ReadAheadSegment();
+#endif
+}
+
+/**
+  * @brief  Gets the statistics of the current or last file read or write on this ftp server.
+	* @param  stats: A pointer to a statistics structure to receive the statistics.
+  * @retval None.
+  */
+void MatrixFTPServer_GetStats(FTP_TRANSFER_STATS *stats)
+{
+	if (NULL != stats)
+		*stats = MatrixFTPServer.stats;
 }
 
 /**
@@ -134,14 +177,29 @@ void MatrixFTPServer_ClientRequestIn(uint16_t senderAddress, uint16_t requestKey
 		return;
 	}
 	
+	//	a transfer start clears the statistics and read-ahead, and a segment request adds the time
+	//	since the last response to the time spent waiting on the bus
+	if ((requestKey == KeyRequestFileReadStart) || (requestKey == KeyRequestFileWriteStart))
+	{
+		memset(&MatrixFTPServer.stats, 0, sizeof(FTP_TRANSFER_STATS));
+		MatrixFTPServer.lastSegmentIndex = -1;
+#ifdef MATRIX_FTP_SERVER_READ_AHEAD
+		MatrixFTPServer.readAhead.isPending = false;
+		MatrixFTPServer.readAhead.isValid = false;
+#endif
+	}
+	else if ((KeyNull != MatrixFTPServer.client.request)
+		&& ((requestKey == KeyRequestFileReadSegment) || (requestKey == KeyRequestFileWriteSegment)))
+		MatrixFTPServer.stats.busTime += (Matrix.systemTime - MatrixFTPServer.responseTime);
+
 	//	save client request and address, and retstart transaction timer
 	MatrixFTPServer.client.request = requestKey;
 	MatrixFTPServer.client.address = senderAddress;
 	MatrixFTPServer.client.requestTimeout =
     Matrix.systemTime + MATRIX_MAX_FILE_REQUEST_RESPONSE_TIME_MS;
 	
-	//	set the receiver sender address filter
-	MatrixReceiver_SetSenderAddressFilter(MatrixFTPServer.client.address);
+	//	set the receiver session address
+	MatrixReceiver_SetSessionAddress(MatrixFTPServer.client.address);
 
 	//	handle request
 	switch (requestKey)
@@ -167,16 +225,23 @@ void MatrixFTPServer_ClientRequestIn(uint16_t senderAddress, uint16_t requestKey
 		case KeyRequestFileDelete:
 			HandleFileEraseRequest(body, bodySize);
 			break;
+
+		case KeyRequestFileDirectory:
+			HandleFileDirectoryRequest(body, bodySize);
+			break;
 		
 		case KeyRequestFileTransferComplete:
 			//	clear the request and receiver address filter
 			MatrixFTPServer.client.request = KeyNull;
-			MatrixReceiver_SetSenderAddressFilter(0);
+			MatrixReceiver_SetSessionAddress(0);
 			break;
 
 		default:
 				break;
 	}
+
+	//	save the response time
+	MatrixFTPServer.responseTime = Matrix.systemTime;
 }
 
 
@@ -201,6 +266,48 @@ uint32_t GenerateServerAccessCode(uint32_t guid[4])
 	return value;
 }
 
+/**
+	* @brief  Limits a requested file segment length to this device's segment length limits,
+	*					rounding down to a power of two.
+	* @param  segmentLength: The requested segment length.
+  * @retval The segment length that this device can use.
+  */
+uint16_t MatrixFTPServer_LimitFileSegmentLength(uint32_t segmentLength)
+{
+	uint32_t length;
+	
+	//	find the largest power of two within limits
+	length = MATRIX_FTP_MIN_SEGMENT_LENGTH;
+	while (((length << 1) <= segmentLength) && ((length << 1) <= MATRIX_FTP_MAX_SEGMENT_LENGTH))
+		length <<= 1;
+	return (uint16_t)length;
+}
+
+/**
+	* @brief  Helper method gets the time used to measure flash accesses.
+	* @param  None.
+  * @retval The system time in milliseconds.
+  */
+static uint32_t GetFlashTime(void)
+{
+	if ((NULL != Matrix.appInterface) && (NULL != Matrix.appInterface->getSystemTime))
+		return Matrix.appInterface->getSystemTime();
+	return Matrix.systemTime;
+}
+
+/**
+	* @brief  Helper method counts a transferred segment, and whether it is a repeat.
+	* @param  segmentIndex: The segment index.
+  * @retval None.
+  */
+static void CountSegment(uint16_t segmentIndex)
+{
+	++MatrixFTPServer.stats.numSegments;
+	if ((int32_t)segmentIndex == MatrixFTPServer.lastSegmentIndex)
+		++MatrixFTPServer.stats.numRetransmits;
+	MatrixFTPServer.lastSegmentIndex = segmentIndex;
+}
+
 /**
 	* @brief  Helper method validates the given server access code.
 	* @param  code: A pointer to a byte array that contains code.
@@ -244,7 +351,7 @@ static void RefuseRequest(uint16_t responseKey)
 	
 	//	clear the request and receiver address filter
 	MatrixFTPServer.client.request = KeyNull;
-	MatrixReceiver_SetSenderAddressFilter(0);
+	MatrixReceiver_SetSessionAddress(0);
 
 	//	send the response
 	token.key = responseKey;
@@ -264,13 +371,15 @@ static void RefuseRequest(uint16_t responseKey)
 static void HandleFileInfoReadStartRequest(uint16_t senderAddress,
 	uint8_t *body, uint32_t bodySize,	uint16_t requestKey)
 {
-	uint16_t i, filenameLen;
+	uint16_t i, filenameLen, segmentLength = 0;
 	uint32_t guid[4], fileIndex;
 	bool sendingGuid = false;
 
 	
-	//	clear the file params
+	//	clear the file params, handle and segment length
 	memset(&MatrixFTPServer.file, 0, sizeof(MATRIX_FILE_METADATA));
+	MatrixFTPServer.handle.isOpen = false;
+	MatrixFTPServer.segmentLength = MATRIX_MAX_FILE_SEGMENT_LENGTH;
 	
 	//	if an indexed file request
 	if (KeyRequestFileIndexedInfo == requestKey)
@@ -341,6 +450,16 @@ static void HandleFileInfoReadStartRequest(uint16_t senderAddress,
 			return;
 		}
 		
+		//	if a read start with a requested segment length, then limit it to what this device supports
+		if ((KeyRequestFileReadStart == requestKey)
+			&& ((uint32_t)(filenameLen + (1 + 4 + 2)) <= bodySize))
+		{
+			body += 4;
+			segmentLength = ((uint16_t)body[0] << 8) | body[1];
+			segmentLength = MatrixFTPServer_LimitFileSegmentLength(segmentLength);
+			MatrixFTPServer.segmentLength = segmentLength;
+		}
+		
 		//	try to get the volume to which the file belongs
 		MatrixFTPServer.file.volumeIndex = 0;
 		if ((NULL != Matrix.appInterface) && (NULL != Matrix.appInterface->fileNameToVolumeIndex))
@@ -355,10 +474,10 @@ static void HandleFileInfoReadStartRequest(uint16_t senderAddress,
 				(uint8_t *)MatrixFTPServer.file.dataLocation, MatrixFTPServer.file.dataSize);
 		}
 		
-		//	else if file found on flash drive volume
+		//	else if file found on flash drive volume, then open it for reading
 		else if (0 == FlashDrive_GetFileMetadata(&MatrixFTPServer.file))
 		{
-			//	nothing to do here
+			OpenFileHandle();
 		}
 		
 		//	else file not available but sending guid
@@ -398,6 +517,10 @@ static void HandleFileInfoReadStartRequest(uint16_t senderAddress,
 	//	send the timestamp
 	MatrixTransmitter_AddInt32(MatrixFTPServer.file.timestamp);
 	
+	//	if negotiating the segment length, send the segment length
+	if (0 != segmentLength)
+		MatrixTransmitter_AddInt16(segmentLength);
+	
 	//	if product info file info request, send the guid
 	if (sendingGuid)
 	{
@@ -425,7 +548,7 @@ static void HandleFileReadSegmentRequest(uint8_t *body, uint32_t bodySize)
 {
 	uint8_t buffer[16];
 	uint16_t i, segmentIndex;
-	uint32_t dataLocation, lastDataLocation;
+	uint32_t dataLocation, lastDataLocation, flashTime;
 
 	
 	//	if file params not set, then refuse request
@@ -458,6 +581,13 @@ static void HandleFileReadSegmentRequest(uint8_t *body, uint32_t bodySize)
 		return;
 	}
 	
+	//	if a flash drive file, then it must not have been moved or erased
+	if (MatrixFTPServer.handle.isOpen && (0 != ValidateFileHandle()))
+	{
+		RefuseRequest(KeyResponseFileNotFound);
+		return;
+	}
+	
 	//	initialize the transmitter
 	MatrixTransmitter_StartMessage(MatrixFTPServer.client.address);
 
@@ -466,27 +596,91 @@ static void HandleFileReadSegmentRequest(uint8_t *body, uint32_t bodySize)
 
 	//	send the segment index
 	MatrixTransmitter_AddInt16(segmentIndex);
+	CountSegment(segmentIndex);
 
 	//	send the data
+	flashTime = GetFlashTime();
 	dataLocation = MatrixFTPServer.file.dataLocation + 
-		(segmentIndex * MATRIX_MAX_FILE_SEGMENT_LENGTH);
-	lastDataLocation = MIN((dataLocation + MATRIX_MAX_FILE_SEGMENT_LENGTH),
+		((uint32_t)segmentIndex * MatrixFTPServer.segmentLength);
+	lastDataLocation = MIN((dataLocation + MatrixFTPServer.segmentLength),
 		(MatrixFTPServer.file.dataLocation + MatrixFTPServer.file.dataSize));
-	while (dataLocation < lastDataLocation)
+	//	volume 0 is pointer-accessible, so frames are built straight from flash
+	if (0 == MatrixFTPServer.file.volumeIndex)
 	{
-		//	get bytes to read
-		i = MIN(16, ((uint32_t)lastDataLocation - (uint32_t)dataLocation));
-		if ((NULL != Matrix.appInterface) && (NULL != Matrix.appInterface->flashRead))
-			Matrix.appInterface->flashRead(MatrixFTPServer.file.volumeIndex, dataLocation, buffer, i);
-		for (segmentIndex = 0; segmentIndex < i; ++segmentIndex)
-			MatrixTransmitter_AddByte(buffer[segmentIndex]);
-		dataLocation += i;
+		if (dataLocation < lastDataLocation)
+			MatrixTransmitter_AddBytes((uint8_t *)(uintptr_t)dataLocation, lastDataLocation - dataLocation);
 	}
 	
+#ifdef MATRIX_FTP_SERVER_READ_AHEAD
+	//	else if the segment was read ahead, then send it from the read-ahead buffer
+	else if (MatrixFTPServer.readAhead.isValid && (segmentIndex == MatrixFTPServer.readAhead.segmentIndex)
+		&& (MatrixFTPServer.readAhead.volumeRevision == FlashDrive_GetVolumeRevision(MatrixFTPServer.file.volumeIndex))
+		&& (MatrixFTPServer.readAhead.length == ((dataLocation < lastDataLocation) ? (lastDataLocation - dataLocation) : 0)))
+	{
+		MatrixTransmitter_AddBytes(MatrixFTPServer.readAhead.buffer, MatrixFTPServer.readAhead.length);
+	}
+#endif
+	else
+	{
+		while (dataLocation < lastDataLocation)
+		{
+			//	get bytes to read
+			i = MIN(16, ((uint32_t)lastDataLocation - (uint32_t)dataLocation));
+			if ((NULL != Matrix.appInterface) && (NULL != Matrix.appInterface->flashRead))
+				Matrix.appInterface->flashRead(MatrixFTPServer.file.volumeIndex, dataLocation, buffer, i);
+			MatrixTransmitter_AddBytes(buffer, i);
+			dataLocation += i;
+		}
+	}
+	MatrixFTPServer.stats.flashTime += (GetFlashTime() - flashTime);
+	
 	//	send remaining part of message in fifo
 	MatrixTransmitter_FinishMessage();
+	
+#ifdef MATRIX_FTP_SERVER_READ_AHEAD
+	//	if more segments on a volume that is not pointer-accessible, then read ahead the next one
+	MatrixFTPServer.readAhead.isValid = false;
+	MatrixFTPServer.readAhead.isPending = (0 != MatrixFTPServer.file.volumeIndex)
+		&& (lastDataLocation < (MatrixFTPServer.file.dataLocation + MatrixFTPServer.file.dataSize));
+	MatrixFTPServer.readAhead.segmentIndex = segmentIndex + 1;
+#endif
 }
 
+#ifdef MATRIX_FTP_SERVER_READ_AHEAD
+/**
+  * @brief  Reads the pending read-ahead segment from flash.
+	* @param  None.
+  * @retval None.
+  */
+static void ReadAheadSegment(void)
+{
+	uint32_t dataLocation, lastDataLocation, flashTime;
+	
+	//	the read must still be in progress, and the file must not have been moved or erased
+	MatrixFTPServer.readAhead.isPending = false;
+	if ((KeyRequestFileReadSegment != MatrixFTPServer.client.request)
+		|| (NULL == Matrix.appInterface) || (NULL == Matrix.appInterface->flashRead)
+		|| (MatrixFTPServer.handle.isOpen && (0 != ValidateFileHandle())))
+		return;
+	
+	//	get the segment location
+	dataLocation = MatrixFTPServer.file.dataLocation + 
+		((uint32_t)MatrixFTPServer.readAhead.segmentIndex * MatrixFTPServer.segmentLength);
+	lastDataLocation = MIN((dataLocation + MatrixFTPServer.segmentLength),
+		(MatrixFTPServer.file.dataLocation + MatrixFTPServer.file.dataSize));
+	if ((dataLocation >= lastDataLocation) || (MatrixFTPServer.segmentLength > MATRIX_FTP_MAX_SEGMENT_LENGTH))
+		return;
+	
+	//	read the segment
+	flashTime = GetFlashTime();
+	MatrixFTPServer.readAhead.length = (uint16_t)(lastDataLocation - dataLocation);
+	MatrixFTPServer.readAhead.volumeRevision = FlashDrive_GetVolumeRevision(MatrixFTPServer.file.volumeIndex);
+	MatrixFTPServer.readAhead.isValid = (0 == Matrix.appInterface->flashRead(MatrixFTPServer.file.volumeIndex,
+		dataLocation, MatrixFTPServer.readAhead.buffer, MatrixFTPServer.readAhead.length));
+	MatrixFTPServer.stats.flashTime += (GetFlashTime() - flashTime);
+}
+#endif
+
 /**
   * @brief  Handles a file write start request.
 	* @param  senderAddress: The requestor CAN address.
@@ -496,11 +690,14 @@ static void HandleFileReadSegmentRequest(uint8_t *body, uint32_t bodySize)
   */
 static void HandleFileWriteStartRequest(uint16_t senderAddress, uint8_t *body, uint32_t bodySize)
 {
-	uint16_t i, filenameLen;
+	uint16_t i, filenameLen, segmentLength;
+	uint32_t resumeOffset;
 
 	
-	//	clear the file params
+	//	clear the file params, handle and segment length
 	memset(&MatrixFTPServer.file, 0, sizeof(MATRIX_FILE_METADATA));
+	MatrixFTPServer.handle.isOpen = false;
+	MatrixFTPServer.segmentLength = MATRIX_MAX_FILE_SEGMENT_LENGTH;
 
 	//	client must provide valid file name
 	filenameLen = FlashDrive_ValidateFileName((char *)body);
@@ -547,20 +744,54 @@ static void HandleFileWriteStartRequest(uint16_t senderAddress, uint8_t *body, u
 		RefuseRequest(KeyResponseFtpClientError);
 		return;
 	}
+	body += 4;
+
+	//	get the optional resume offset
+	resumeOffset = 0;
+	if ((uint32_t)(filenameLen + (1 + 4 + 2 + 4 + 4 + 4)) <= bodySize)
+	{
+		i = 4;
+		while (i--)
+		{
+			resumeOffset <<= 8;
+			resumeOffset |= *body++;
+		}
+	}
+	
+	//	get the optional segment length, and limit it to what this device supports
+	segmentLength = 0;
+	if ((uint32_t)(filenameLen + (1 + 4 + 2 + 4 + 4 + 4 + 2)) <= bodySize)
+	{
+		segmentLength = ((uint16_t)body[0] << 8) | body[1];
+		segmentLength = MatrixFTPServer_LimitFileSegmentLength(segmentLength);
+		MatrixFTPServer.segmentLength = segmentLength;
+	}
 
 	//	try to get the volume to which the file belongs
 	MatrixFTPServer.file.volumeIndex = 0;
 	if ((NULL != Matrix.appInterface) && (NULL != Matrix.appInterface->fileNameToVolumeIndex))
 		MatrixFTPServer.file.volumeIndex = Matrix.appInterface->fileNameToVolumeIndex(MatrixFTPServer.file.name);
 
-	//	try to write the file header and allocate the data in flash
-	if (0 != FlashDrive_WriteFileHeader(&MatrixFTPServer.file)
-		|| (0 != FlashDrive_GetFileMetadata(&MatrixFTPServer.file)))
+	//	if cannot resume a pending write of the same file,
+	//	then try to write the file header and allocate the data in flash
+	if (!CanResumeFileWrite(resumeOffset))
+	{
+		resumeOffset = 0;
+		if (0 != FlashDrive_WriteFileHeader(&MatrixFTPServer.file))
+		{
+			//	if cannot be written then refuse request with a disk full response
+			RefuseRequest(KeyResponseFtpDiskFull);
+			return;
+		}
+	}
+	
+	//	open the file for writing
+	if (0 != OpenFileHandle())
 	{
-		//	if cannot be written then refuse request with a disk full response
 		RefuseRequest(KeyResponseFtpDiskFull);
 		return;
 	}
+	MatrixFTPServer.handle.writeOffset = resumeOffset;
 	
 	//	start a message
 	MatrixTransmitter_StartMessage(MatrixFTPServer.client.address);
@@ -571,10 +802,117 @@ static void HandleFileWriteStartRequest(uint16_t senderAddress, uint8_t *body, u
 	//	send the file name
 	MatrixTransmitter_AddString(MatrixFTPServer.file.name);
 
+	//	if resuming or negotiating the segment length, send the accepted resume offset
+	if ((0 != resumeOffset) || (0 != segmentLength))
+		MatrixTransmitter_AddInt32(resumeOffset);
+	
+	//	if negotiating the segment length, send the segment length
+	if (0 != segmentLength)
+		MatrixTransmitter_AddInt16(segmentLength);
+
 	//	finish the message
 	MatrixTransmitter_FinishMessage();
 }
 
+/**
+  * @brief  Determines whether a file write can resume from the given offset.
+	*					The file must already be on the volume with the same data size,
+	*					data checksum and timestamp, and its data from the resume offset
+	*					onward must still be erased, so that a previous write was interrupted.
+	*
+	*					On success the server file metadata is set from the pending file.
+	*
+	* @param  resumeOffset: The requested resume offset, on a segment boundary.
+  * @retval Returns true if the write can resume.
+  */
+static bool CanResumeFileWrite(uint32_t resumeOffset)
+{
+	MATRIX_FILE_METADATA pending;
+	uint8_t buffer[16];
+	uint32_t dataLocation, lastDataLocation;
+	uint16_t i, n;
+
+	//	validate the offset
+	if ((0 == resumeOffset) || (resumeOffset >= MatrixFTPServer.file.dataSize)
+		|| (0 != (resumeOffset & (MatrixFTPServer.segmentLength - 1))))
+		return false;
+
+	//	verify app support
+	if ((NULL == Matrix.appInterface) || (NULL == Matrix.appInterface->flashRead))
+		return false;
+
+	//	the file must exist with the same identity
+	memcpy(&pending, &MatrixFTPServer.file, sizeof(MATRIX_FILE_METADATA));
+	if ((0 != FlashDrive_GetFileMetadata(&pending))
+		|| (pending.dataSize != MatrixFTPServer.file.dataSize)
+		|| (pending.dataChecksum != MatrixFTPServer.file.dataChecksum)
+		|| (pending.timestamp != MatrixFTPServer.file.timestamp))
+		return false;
+
+	//	the data not yet written must still be erased
+	dataLocation = pending.dataLocation + resumeOffset;
+	lastDataLocation = pending.dataLocation + pending.dataSize;
+	while (dataLocation < lastDataLocation)
+	{
+		n = MIN(16, (lastDataLocation - dataLocation));
+		if (0 != Matrix.appInterface->flashRead(pending.volumeIndex, dataLocation, buffer, n))
+			return false;
+		for (i = 0; i < n; ++i)
+			if (FLASH_DRIVE_FILE_ERASE_VALUE != buffer[i])
+				return false;
+		dataLocation += n;
+	}
+
+	//	resume with the pending file
+	memcpy(&MatrixFTPServer.file, &pending, sizeof(MATRIX_FILE_METADATA));
+	return true;
+}
+
+/**
+  * @brief  Opens the server file on its flash drive volume,
+	*					setting the file handle and the file data location.
+	* @param  None.
+  * @retval Returns 0 if the file is found, else -1.
+  */
+static int OpenFileHandle(void)
+{
+	FLASH_DRIVE_FILE header;
+
+	//	find the file
+	MatrixFTPServer.handle.isOpen = false;
+	if (0 != FlashDrive_GetFile(MatrixFTPServer.file.volumeIndex, MatrixFTPServer.file.name,
+		&header, &MatrixFTPServer.handle.headerLocation))
+		return -1;
+	
+	//	must be the same file
+	if ((header.dataSize != MatrixFTPServer.file.dataSize)
+		|| (header.timestamp != MatrixFTPServer.file.timestamp))
+		return -1;
+
+	//	set the handle
+	MatrixFTPServer.file.dataLocation = header.dataLocation;
+	MatrixFTPServer.handle.volumeRevision = FlashDrive_GetVolumeRevision(MatrixFTPServer.file.volumeIndex);
+	MatrixFTPServer.handle.isOpen = true;
+	return 0;
+}
+
+/**
+  * @brief  Validates the open file handle.
+	*					If files may have moved since the handle was set, then re-opens the file.
+	* @param  None.
+  * @retval Returns 0 if the handle is valid, else -1.
+  */
+static int ValidateFileHandle(void)
+{
+	//	if volume unchanged, then handle is good
+	if (MatrixFTPServer.handle.volumeRevision ==
+		FlashDrive_GetVolumeRevision(MatrixFTPServer.file.volumeIndex))
+		return 0;
+	
+	//	else re-open the file
+	return OpenFileHandle();
+}
+
 /**
   * @brief  Handles a file write segment request.
 	* @param  senderAddress: The requestor CAN address.
@@ -585,7 +923,7 @@ static void HandleFileWriteStartRequest(uint16_t senderAddress, uint8_t *body, u
 static void HandleFileWriteSegmentRequest(uint8_t *body, uint32_t bodySize)
 {
 	uint16_t i, segmentIndex;
-	uint32_t locationOffset;
+	uint32_t locationOffset, flashTime, skipSize;
 	
 	//	if file params not set, then refuse request
 	if (0 == MatrixFTPServer.file.dataSize)
@@ -595,7 +933,7 @@ static void HandleFileWriteSegmentRequest(uint8_t *body, uint32_t bodySize)
 	}
 	
 	//	client must provide body with correct size
-	if ((NULL == body) || (3 > bodySize))
+	if ((NULL == body) || ((2 + 4 + 1) > bodySize))
 	{
 		RefuseRequest(KeyResponseFtpClientError);
 		return;
@@ -610,7 +948,7 @@ static void HandleFileWriteSegmentRequest(uint8_t *body, uint32_t bodySize)
 		segmentIndex |= *body++;
 	}
 	bodySize -= 2;
-	locationOffset = segmentIndex * MATRIX_MAX_FILE_SEGMENT_LENGTH;
+	locationOffset = (uint32_t)segmentIndex * MatrixFTPServer.segmentLength;
 	
 	//	client must provide valid server access code
 	if (!ValidateServerAccessCode(body))
@@ -621,14 +959,36 @@ static void HandleFileWriteSegmentRequest(uint8_t *body, uint32_t bodySize)
 	body += 4;
 	bodySize -= 4;
 	
-	//	write the file data
-	if (0 != FlashDrive_WriteData(MatrixFTPServer.file.volumeIndex,
-		MatrixFTPServer.file.name, body, bodySize, locationOffset))
+	//	the file must still be open, and the data must be within the file
+	if ((NULL == Matrix.appInterface) || (NULL == Matrix.appInterface->flashWrite)
+		|| (!MatrixFTPServer.handle.isOpen) || (0 != ValidateFileHandle())
+		|| (0 == bodySize) || (locationOffset >= MatrixFTPServer.file.dataSize)
+		|| ((locationOffset + bodySize) > MatrixFTPServer.file.dataSize))
 	{
 		RefuseRequest(KeyResponseFtpClientError);
 		return;
 	}
 	
+	//	write the file data, unless a repeated segment that was already written,
+	//	skipping any part of the segment that was already written
+	CountSegment(segmentIndex);
+	if ((locationOffset + bodySize) > MatrixFTPServer.handle.writeOffset)
+	{
+		skipSize = 0;
+		if (MatrixFTPServer.handle.writeOffset > locationOffset)
+			skipSize = MatrixFTPServer.handle.writeOffset - locationOffset;
+		flashTime = GetFlashTime();
+		if (0 != Matrix.appInterface->flashWrite(MatrixFTPServer.file.volumeIndex,
+			MatrixFTPServer.file.dataLocation + locationOffset + skipSize,
+			body + skipSize, bodySize - skipSize))
+		{
+			RefuseRequest(KeyResponseFtpClientError);
+			return;
+		}
+		MatrixFTPServer.stats.flashTime += (GetFlashTime() - flashTime);
+		MatrixFTPServer.handle.writeOffset = locationOffset + bodySize;
+	}
+	
 	//	start a message
 	MatrixTransmitter_StartMessage(MatrixFTPServer.client.address);
 
@@ -709,3 +1069,139 @@ static void HandleFileEraseRequest(uint8_t *body, uint32_t bodySize)
 	//	finish the message
 	MatrixTransmitter_FinishMessage();
 }
+
+/**
+  * @brief  Handles a request for a page of a volume directory, or of the manifest
+	*					of all volumes when the volume index is FTP_MANIFEST_VOLUME_INDEX.
+	*					The page is built in a single pass over the volume file headers,
+	*					and holds as many file records as fit in the directory page size.
+	*					Files provided by the application read handler are not listed.
+	*
+	*					Request body:  [volume index 2][start file index 4][access code 4]
+	*					Response body: [volume index 2][start file index 4]
+	*												 {[file volume index 2 if manifest][file name]
+	*													[data size 4][data checksum 2][timestamp 4]}...
+	*												 [last page flag 1]
+	*
+	* @param  body: A pointer to the message body.
+	* @param  bodySize: The message body size in bytes.
+  * @retval None.
+  */
+static void HandleFileDirectoryRequest(uint8_t *body, uint32_t bodySize)
+{
+	FLASH_DRIVE_FILE header;
+	char filename[MATRIX_FILE_NAME_LENGTH + 1];
+	uint16_t i, volumeIndex, fileVolumeIndex, lastVolumeIndex, recordSize;
+	uint32_t startIndex, fileIndex, pageSize;
+	uint32_t volumeHeaderAddress, volumeLastAddress;
+	bool isManifest, isLastPage;
+
+	//	client must provide required fields
+	if ((NULL == body) || ((2 + 4 + 4) > bodySize))
+	{
+		RefuseRequest(KeyResponseFtpClientError);
+		return;
+	}
+
+	//	get the volume index
+	i = 2;
+	volumeIndex = 0;
+	while (i--)
+	{
+		volumeIndex <<= 8;
+		volumeIndex |= *body++;
+	}
+
+	//	get the start file index
+	i = 4;
+	startIndex = 0;
+	while (i--)
+	{
+		startIndex <<= 8;
+		startIndex |= *body++;
+	}
+
+	//	client must provide valid server access code
+	if (!ValidateServerAccessCode(body))
+	{
+		RefuseRequest(KeyResponseFtpClientError);
+		return;
+	}
+
+	//	the volume must exist, or be the manifest of all volumes
+	isManifest = (FTP_MANIFEST_VOLUME_INDEX == volumeIndex);
+	if ((NULL == Matrix.appInterface) || (NULL == Matrix.appInterface->flashRead)
+		|| (!isManifest && (volumeIndex >= GetNumVolumes())))
+	{
+		RefuseRequest(KeyResponseFileNotFound);
+		return;
+	}
+
+	//	initialize the transmitter
+	MatrixTransmitter_StartMessage(MatrixFTPServer.client.address);
+
+	//	send the response key, volume index and start file index
+	MatrixTransmitter_AddInt16(KeyResponseFileDirectory);
+	MatrixTransmitter_AddInt16(volumeIndex);
+	MatrixTransmitter_AddInt32(startIndex);
+	pageSize = 2 + 4 + 1;
+
+	//	for the requested volume, or all volumes
+	fileVolumeIndex = isManifest ? 0 : volumeIndex;
+	lastVolumeIndex = isManifest ? GetNumVolumes() : (volumeIndex + 1);
+	fileIndex = 0;
+	isLastPage = true;
+	for ( ; isLastPage && (fileVolumeIndex < lastVolumeIndex); ++fileVolumeIndex)
+	{
+		//	while file headers
+		volumeHeaderAddress = Matrix.appInterface->flashVolumes[fileVolumeIndex].baseAddress;
+		volumeLastAddress = volumeHeaderAddress + Matrix.appInterface->flashVolumes[fileVolumeIndex].size;
+		while (volumeHeaderAddress < volumeLastAddress)
+		{
+			//	read in header
+			FlashDrive_ReadFileHeader(fileVolumeIndex, volumeHeaderAddress, &header);
+			
+			//	if header not written, then break
+			if (FLASH_DRIVE_FILE_KEY_UNUSED == header.key)
+				break;
+			
+			//	if active file found and header not corrupt
+			if ((FLASH_DRIVE_FILE_KEY_ACTIVE == header.key)
+				&& (header.checksum == FlashDrive_ComputeHeaderCRC16(&header)))
+			{
+				//	if at or past the start index, then add the file record
+				if (fileIndex >= startIndex)
+				{
+					//	if the record does not fit, then the client must request another page
+					strncpy(filename, header.name, MATRIX_FILE_NAME_LENGTH);
+					filename[MATRIX_FILE_NAME_LENGTH] = 0;
+					recordSize = (uint16_t)strlen(filename) + (1 + 4 + 2 + 4) + (isManifest ? 2 : 0);
+					if ((pageSize + recordSize) > MATRIX_FTP_DIRECTORY_PAGE_SIZE)
+					{
+						isLastPage = false;
+						break;
+					}
+					pageSize += recordSize;
+
+					//	send the file record
+					if (isManifest)
+						MatrixTransmitter_AddInt16(fileVolumeIndex);
+					MatrixTransmitter_AddString(filename);
+					MatrixTransmitter_AddInt32(header.dataSize);
+					MatrixTransmitter_AddInt16(header.dataChecksum);
+					MatrixTransmitter_AddInt32(header.timestamp);
+				}
+				++fileIndex;
+			}
+			
+			//	bump address
+			volumeHeaderAddress += sizeof(FLASH_DRIVE_FILE);
+		}
+	}
+
+	//	send the last page flag
+	MatrixTransmitter_AddByte(isLastPage ? 1 : 0);
+
+	//	send remaining part of message in fifo
+	MatrixTransmitter_FinishMessage();
+}
@@ -21,6 +21,7 @@
 
 #include <stdio.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "matrix_tokens.h"
 #include "matrix_config.h"
 #include "matrix_flash_drive.h"
@@ -44,6 +45,56 @@ typedef struct
 } MFTP_CLIENT;
 
 
+/**
+  * @brief  The Matrix ftp server open file handle.
+	*					Resolved when a transfer starts, and resolved again only
+	*					if the volume revision shows that files may have moved.
+  */
+typedef struct
+{
+	//	the file header location in flash
+	uint32_t headerLocation;
+	
+	//	the end of the file data written so far
+	uint32_t writeOffset;
+	
+	//	the volume revision when the handle was resolved
+	uint16_t volumeRevision;
+	
+	//	true if the handle refers to a flash drive file
+	bool isOpen;
+	
+} MFTP_FILE_HANDLE;
+
+#ifdef MATRIX_FTP_SERVER_READ_AHEAD
+/**
+  * @brief  The Matrix ftp server read-ahead segment.
+	*					For volumes that are not pointer-accessible, the segment after the
+	*					one just sent is read from flash during idle clocks.
+  */
+typedef struct
+{
+	//	the segment data
+	uint8_t buffer[MATRIX_FTP_MAX_SEGMENT_LENGTH];
+	
+	//	the segment index
+	uint16_t segmentIndex;
+	
+	//	the number of data bytes in the buffer
+	uint16_t length;
+	
+	//	the volume revision when the segment was read
+	uint16_t volumeRevision;
+	
+	//	true if the segment is to be read on the next clock
+	bool isPending;
+	
+	//	true if the buffer holds the segment
+	bool isValid;
+	
+} MFTP_READ_AHEAD;
+#endif
+
 /**
   * @brief  The Matrix ftp server object.
   */
@@ -55,9 +106,25 @@ typedef struct
 	//	the file
 	MATRIX_FILE_METADATA file;
 	
+	//	the open file handle
+	MFTP_FILE_HANDLE handle;
+	
+	//	the segment length for the current transfer
+	uint16_t segmentLength;
+	
+#ifdef MATRIX_FTP_SERVER_READ_AHEAD
+	//	the read-ahead segment
+	MFTP_READ_AHEAD readAhead;
+#endif
+	
 	//	this server's access code
 	uint32_t accessCode;
 
+	//	the transfer statistics, the last segment index and the last response time
+	FTP_TRANSFER_STATS stats;
+	int32_t lastSegmentIndex;
+	uint32_t responseTime;
+
 } MATRIX_FTP_SERVER_OBJECT;
 //	private extern MATRIX_FTP_SERVER_OBJECT MatrixFTPServer;
 
@@ -88,6 +155,15 @@ void MatrixFTPServer_Clock(void);
 void MatrixFTPServer_ClientRequestIn(uint16_t senderAddress, uint16_t requestKey,
 	uint8_t *body, uint32_t bodySize);
 
+/**
+	* @brief  Limits a requested file segment length to this device's segment length limits,
+	*					rounding down to a power of two.
+	*					Shared by the ftp client and server.
+	* @param  segmentLength: The requested segment length.
+  * @retval The segment length that this device can use.
+  */
+uint16_t MatrixFTPServer_LimitFileSegmentLength(uint32_t segmentLength);
+
 
 #endif  //  __MATRIX_FTP_SERVER_H
 
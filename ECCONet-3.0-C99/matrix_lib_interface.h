@@ -93,6 +93,14 @@ typedef uint8_t (*MATRIX_FILE_NAME_TO_VOLUME_INDEX)(char *filename);
   */
 typedef void (*MATRIX_GET_GUID)(uint32_t guid[4]);
 
+/**
+  * @brief  Prototype to get the current system time.
+	*					Used to time flash accesses within a clock, which the clocked system time cannot.
+	* @param  None.
+  * @retval The 32-bit system time in milliseconds.
+  */
+typedef uint32_t (*MATRIX_GET_SYSTEM_TIME)(void);
+
 /**
   * @brief  Prototype for the FTP server to route a file read request through the application.
 	*
@@ -108,6 +116,18 @@ typedef void (*MATRIX_GET_GUID)(uint32_t guid[4]);
   */
 typedef int (*MATRIX_FTP_SERVER_FILE_READ_HANDLER)(uint16_t requesterAddress, MATRIX_FILE_METADATA *fileInfo);
 
+/**
+  * @brief  Prototype for the library to report that the app firmware image does not match
+	*					the CRC32 in its flash file footer.
+	*
+	*					The application should clear the bootloader verified-image marker, so that the
+	*					bootloader computes the CRC32 on the next cold boot and keeps the image from running.
+	*
+	* @param  None.
+  * @retval None.
+  */
+typedef void (*MATRIX_APP_FIRMWARE_CRC_ERROR)(void);
+
 
 ///////////////////////////////////////////////////////////////////////
 //
@@ -131,6 +151,20 @@ typedef struct
 
 } MATRIX_DRIVE_VOLUME;
 
+/**
+  * @brief  A firmware image structure.
+	*					The image must be accessable via pointer.
+  */
+typedef struct
+{
+	//	the base address of the image
+	uint32_t baseAddress;
+
+	//	the size of the image
+	uint32_t size;
+
+} MATRIX_FIRMWARE_IMAGE;
+
 /**
   * @brief  Prototype for Matrix interface.
   */
@@ -167,6 +201,18 @@ typedef struct
 	//
 	MATRIX_DRIVE_VOLUME flashVolumes[MATRIX_FLASH_DRIVE_MAX_NUM_VOLUMES];
 	
+	//	the method to get the current system time, for ftp statistics
+	//	this can be null, in which case flash time is not measured
+	MATRIX_GET_SYSTEM_TIME getSystemTime;
+	
+	//	The app firmware image, from which the library computes and caches the
+	//	app firmware CRC to answer app firmware CRC requests.
+	//	An image with zero size leaves those requests to the application.
+	MATRIX_FIRMWARE_IMAGE appFirmwareImage;
+	
+	//	the method called when the app firmware image does not match its flash file footer CRC32
+	//	this can be null, in which case the footer CRC32 is not checked
+	MATRIX_APP_FIRMWARE_CRC_ERROR appFirmwareCrcError;
 
 } MATRIX_INTERFACE_TABLE;
 
@@ -245,6 +291,10 @@ typedef struct
 //	The CAN address file is always stored in volume 0.
 #define MATRIX_CAN_ADDRESS_FILE_VOLUME_INDEX	0
 
+//	The last self-assigned CAN address file name.
+//	This file holds a CAN address file object, and is stored in the CAN address file volume.
+#define MATRIX_LAST_CAN_ADDRESS_FILE_NAME	"lastaddr.can"
+
 
 //	The product info file name.
 #define MATRIX_PRODUCT_INFO_FILE_NAME	"product.inf"
@@ -423,6 +473,39 @@ extern uint16_t Matrix_GetTokenSequencerNumPatterns(void);
   */
 extern const uint8_t *Matrix_GetCurrentEquationFile(void);
 
+/**
+  * @brief  Returns a value indicating whether a node has been seen on the bus
+	*					within the node timeout.  The node table is filled from received traffic.
+	* @param  address: The node CAN address.
+  * @retval True if the node is online.
+  */
+extern bool Matrix_IsNodeOnline(uint8_t address);
+
+/**
+  * @brief  Gets the time that a node was last seen on the bus.
+	* @param  address: The node CAN address.
+	* @param  lastSeenTime: A pointer to a variable to receive the system time the node was last seen.
+  * @retval Returns 0 if the node is online, else -1.
+  */
+extern int Matrix_GetNodeLastSeenTime(uint8_t address, uint32_t *lastSeenTime);
+
+/**
+  * @brief  Gets the addresses of the nodes that are online.
+	* @param  addresses: A pointer to an array to receive the addresses.
+	* @param  maxAddresses: The number of addresses the array can hold.
+  * @retval The number of addresses copied to the array.
+  */
+extern uint16_t Matrix_GetOnlineNodes(uint8_t *addresses, uint16_t maxAddresses);
+
+/**
+  * @brief  Invalidates the cached application firmware CRC and starts computing it again.
+	*					Call this if the app firmware image is changed without a reset,
+	*					or periodically to check the image against its flash file footer again.
+	* @param  None.
+  * @retval None.
+  */
+extern void Matrix_InvalidateAppFirmwareCrc(void);
+
 
 
 
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file    		matrix_node_table.c
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		The Matrix table of nodes seen on the CAN bus.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+
+#include <string.h>
+#include "matrix.h"
+#include "matrix_node_table.h"
+
+
+/**
+  * @brief  The Matrix node table data object.
+  */
+MATRIX_NODE_TABLE_OBJECT MatrixNodeTable;
+
+
+/**
+  * @brief  Resets the node table.
+  * @param  None.
+  * @retval None.
+  */
+void MatrixNodeTable_Reset(void)
+{
+	//	clear the table
+	memset(&MatrixNodeTable, 0, sizeof(MATRIX_NODE_TABLE_OBJECT));
+}
+
+/**
+  * @brief  Clocks the node table, aging one address per clock.
+	*					This method supports cooperative task scheduling.
+  * @param  None.
+  * @retval None.
+  */
+void MatrixNodeTable_Clock(void)
+{
+	uint8_t address;
+	
+	//	get the next address to age
+	address = MatrixNodeTable.ageAddress;
+	if (++MatrixNodeTable.ageAddress > MATRIX_CAN_MAX_RESERVED_ADDRESS)
+		MatrixNodeTable.ageAddress = 0;
+	
+	//	if the node has not been seen within the timeout, then it is offline
+	if ((MatrixNodeTable.isOnline[address >> 3] & (1 << (address & 7)))
+		&& (MATRIX_NODE_TABLE_TIMEOUT_MS < (uint16_t)((uint16_t)Matrix.systemTime
+		- MatrixNodeTable.lastSeenTime[address])))
+		MatrixNodeTable.isOnline[address >> 3] &= ~(1 << (address & 7));
+}
+
+/**
+  * @brief  Marks a node as seen now.
+	* @param  address: The node CAN address.
+  * @retval None.
+  */
+void MatrixNodeTable_NodeSeen(uint8_t address)
+{
+	if ((MATRIX_CAN_BROADCAST_ADDRESS == address) || (MATRIX_CAN_MAX_RESERVED_ADDRESS < address))
+		return;
+	MatrixNodeTable.lastSeenTime[address] = (uint16_t)Matrix.systemTime;
+	MatrixNodeTable.isOnline[address >> 3] |= (1 << (address & 7));
+}
+
+/**
+  * @brief  Checks incoming tokens for nodes named by address negotiation.
+	* @param  token: A message token.
+  * @retval None.
+  */
+void MatrixNodeTable_CanTokenIn(TOKEN *token)
+{
+	//	an address-in-use response names a node that holds the address
+	if (KeyResponseAddressInUse == token->key)
+		MatrixNodeTable_NodeSeen((uint8_t)token->value);
+}
+
+/**
+  * @brief  Returns a value indicating whether a node has been seen within the node timeout.
+	* @param  address: The node CAN address.
+  * @retval True if the node is online.
+  */
+bool Matrix_IsNodeOnline(uint8_t address)
+{
+	if (MATRIX_CAN_MAX_RESERVED_ADDRESS < address)
+		return false;
+	return (0 != (MatrixNodeTable.isOnline[address >> 3] & (1 << (address & 7))));
+}
+
+/**
+  * @brief  Gets the time that a node was last seen.
+	* @param  address: The node CAN address.
+	* @param  lastSeenTime: A pointer to a variable to receive the system time the node was last seen.
+  * @retval Returns 0 if the node is online, else -1.
+  */
+int Matrix_GetNodeLastSeenTime(uint8_t address, uint32_t *lastSeenTime)
+{
+	if (!Matrix_IsNodeOnline(address) || (NULL == lastSeenTime))
+		return -1;
+	*lastSeenTime = Matrix.systemTime
+		- (uint16_t)((uint16_t)Matrix.systemTime - MatrixNodeTable.lastSeenTime[address]);
+	return 0;
+}
+
+/**
+  * @brief  Gets the addresses of the nodes that are online.
+	* @param  addresses: A pointer to an array to receive the addresses.
+	* @param  maxAddresses: The number of addresses the array can hold.
+  * @retval The number of addresses copied to the array.
+  */
+uint16_t Matrix_GetOnlineNodes(uint8_t *addresses, uint16_t maxAddresses)
+{
+	uint16_t address, numAddresses;
+	
+	//	validate input
+	if (NULL == addresses)
+		return 0;
+	
+	//	copy the online addresses
+	numAddresses = 0;
+	for (address = MATRIX_CAN_MIN_STANDARD_ADDRESS;
+		(address <= MATRIX_CAN_MAX_RESERVED_ADDRESS) && (numAddresses < maxAddresses); ++address)
+	{
+		if (MatrixNodeTable.isOnline[address >> 3] & (1 << (address & 7)))
+			addresses[numAddresses++] = (uint8_t)address;
+	}
+	return numAddresses;
+}
@@ -0,0 +1,83 @@
+/**
+  ******************************************************************************
+  * @file    		matrix_node_table.h
+  * @copyright   2026 ECCO Safety Group.  All rights reserved.
+  * @author  		ECCO Safety Group
+  * @version 		1.0.0
+  * @date    		October 2026
+  * @brief   		The Matrix table of nodes seen on the CAN bus.
+	*							
+  ******************************************************************************
+  * @attention
+  *
+  * Unless required by applicable law or agreed to in writing, this software
+  * is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF
+  * ANY KIND, either express or implied.
+  *
+  ******************************************************************************
+  */
+
+#ifndef __MATRIX_NODE_TABLE_H
+#define __MATRIX_NODE_TABLE_H
+
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "matrix_config.h"
+#include "matrix_tokens.h"
+
+
+/**
+  * @brief  The Matrix node table data object.
+	*					Nodes are indexed by CAN address, and the last-seen times are
+	*					the lower 16 bits of the system time, which is why the node
+	*					timeout must be well under 65 seconds.
+  */
+typedef struct
+{
+	//	the last-seen time of each address
+	uint16_t lastSeenTime[MATRIX_CAN_MAX_RESERVED_ADDRESS + 1];
+	
+	//	a bit for each address that is online
+	uint8_t isOnline[(MATRIX_CAN_MAX_RESERVED_ADDRESS + 8) / 8];
+	
+	//	the next address to age
+	uint8_t ageAddress;
+	
+} MATRIX_NODE_TABLE_OBJECT;
+//extern MATRIX_NODE_TABLE_OBJECT MatrixNodeTable;
+
+
+/**
+  * @brief  Resets the node table.
+  * @param  None.
+  * @retval None.
+  */
+extern void MatrixNodeTable_Reset(void);
+
+/**
+  * @brief  Clocks the node table, aging one address per clock.
+	*					This method supports cooperative task scheduling.
+  * @param  None.
+  * @retval None.
+  */
+extern void MatrixNodeTable_Clock(void);
+
+/**
+  * @brief  Marks a node as seen now.
+	*					This method is called by the matrix receiver and should
+	*					not normally be called by other modules.
+	* @param  address: The node CAN address.
+  * @retval None.
+  */
+extern void MatrixNodeTable_NodeSeen(uint8_t address);
+
+/**
+  * @brief  Checks incoming tokens for nodes named by address negotiation.
+	* @param  token: A message token.
+  * @retval None.
+  */
+extern void MatrixNodeTable_CanTokenIn(TOKEN *token);
+
+
+#endif  //  __MATRIX_NODE_TABLE_H
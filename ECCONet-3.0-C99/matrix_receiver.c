@@ -15,6 +15,10 @@
 	*							and then re-enables the	interrupt.  The frames are examined,
 	*							and complete messages are decompressed and sent to router.
 	*
+	*							During an ftp session, frames from the session peer are moved
+	*							to a separate session stream buffer instead, so that long ftp
+	*							messages and traffic from other senders are both received.
+	*
   ******************************************************************************
   * @attention
   *
@@ -32,6 +36,7 @@
 #include "matrix_ftp_client.h"
 #include "matrix_ftp_server.h"
 #include "matrix_event_index.h"
+#include "matrix_node_table.h"
 #include "matrix_token_sequencer.h"
 #include "matrix_receiver.h"
 
@@ -39,9 +44,13 @@
 //	private methods
 extern void Matrix_PrivateReceiveCanToken(TOKEN *token);
 extern void Matrix_DelayStatusUpdate15mS(void);
-static void ProcessMessagesInStream(uint16_t numNewFrames);
-static void RemoveUnprocessedFrames(void);
-static void SortNewFrames(uint16_t numNewFrames);
+static void ProcessMessagesInStream(MATRIX_RX_CAN_FRAME *streamBuffer, uint16_t streamBufferSize,
+	uint16_t numNewFrames);
+static void RemoveUnprocessedFrames(MATRIX_RX_CAN_FRAME *streamBuffer, uint16_t streamBufferSize);
+static void SortNewFrames(MATRIX_RX_CAN_FRAME *streamBuffer, uint16_t streamBufferSize,
+	uint16_t numNewFrames);
+static void ShiftStream(MATRIX_RX_CAN_FRAME *streamBuffer, uint16_t streamBufferSize,
+	uint16_t numNewFrames);
 
 
 /**
@@ -65,17 +74,21 @@ void MatrixReceiver_Reset(void)
 	memset(MatrixReceiver.rxBuffer, 0,
 		CAN_RX_STREAM_BUFFER_BACK_SIZE * sizeof(MATRIX_RX_CAN_FRAME));
 
+	//	clear the session stream
+	memset(MatrixReceiver.sessionStreamBuffer, 0,
+		CAN_RX_SESSION_STREAM_BUFFER_SIZE * sizeof(MATRIX_RX_CAN_FRAME));
+
 	//	the the stream indices and block
 	MatrixReceiver.rxBufferWriteIndex = 0;
 	MatrixReceiver.rxBufferReadIndex = 0;
 
-	//	clear the sender address filter
-	MatrixReceiver.senderAddressFilter = 0;
+	//	clear the session address
+	MatrixReceiver.sessionAddress = 0;
 	
-	//	start the sender address filter timer
+	//	start the session timer
 	//	each time this timer expires it automatically re-starts
-	MatrixReceiver.senderAddressFilterTimeout =
-		Matrix.systemTime + MATRIX_MAX_SENDER_ADDRESS_FILTER_TIME_MS;
+	MatrixReceiver.sessionTimeout =
+		Matrix.systemTime + MATRIX_MAX_RX_SESSION_TIME_MS;
 }
 
 /**
@@ -85,17 +98,17 @@ void MatrixReceiver_Reset(void)
   */
 void MatrixReceiver_Clock(void)
 {
-	uint16_t numNewFrames;
-	MATRIX_RX_CAN_FRAME *pFrontBuffer, *pFrontBufferEnd;
+	uint16_t numNewFrames, numSessionFrames, i, n;
+	MATRIX_RX_CAN_FRAME *pFrontBuffer, *pSessionBuffer, *pFrame;
 	
 	
-	//	check the sender address filter timeout
-	if (IsMatrixTimerExpired(MatrixReceiver.senderAddressFilterTimeout))
+	//	check the session timeout
+	if (IsMatrixTimerExpired(MatrixReceiver.sessionTimeout))
 	{
-		//	set next timeout and clear address filter
-		MatrixReceiver.senderAddressFilterTimeout =
-			Matrix.systemTime + MATRIX_MAX_SENDER_ADDRESS_FILTER_TIME_MS;
-		MatrixReceiver.senderAddressFilter = 0;
+		//	set next timeout and clear session address
+		MatrixReceiver.sessionTimeout =
+			Matrix.systemTime + MATRIX_MAX_RX_SESSION_TIME_MS;
+		MatrixReceiver.sessionAddress = 0;
 	}
 
 	//	validate uint rxBufferReadIndex as less than the back buffer size
@@ -110,41 +123,71 @@ void MatrixReceiver_Clock(void)
 	//	if new frames to process
 	if (0 < numNewFrames)
 	{
-		//	shift bytes in front buffer to make room
-		memmove(MatrixReceiver.streamBuffer, MatrixReceiver.streamBuffer + numNewFrames,
-			(CAN_RX_STREAM_BUFFER_FRONT_SIZE - numNewFrames) * sizeof(MATRIX_RX_CAN_FRAME));
-
-		//	copy received bytes into front buffer
-		pFrontBufferEnd = MatrixReceiver.streamBuffer + CAN_RX_STREAM_BUFFER_FRONT_SIZE; 
-		pFrontBuffer =  pFrontBufferEnd - numNewFrames;
-		while (pFrontBuffer < pFrontBufferEnd)
+		//	count the new frames from the session peer
+		numSessionFrames = 0;
+		if (0 != MatrixReceiver.sessionAddress)
+		{
+			i = MatrixReceiver.rxBufferReadIndex;
+			n = numNewFrames;
+			while (n--)
+			{
+				if (MatrixReceiver.rxBuffer[i].senderAddress == MatrixReceiver.sessionAddress)
+					++numSessionFrames;
+				if (++i >= CAN_RX_STREAM_BUFFER_BACK_SIZE)
+					i = 0;
+			}
+		}
+		
+		//	shift frames in front and session buffers to make room
+		ShiftStream(MatrixReceiver.streamBuffer, CAN_RX_STREAM_BUFFER_FRONT_SIZE,
+			numNewFrames - numSessionFrames);
+		ShiftStream(MatrixReceiver.sessionStreamBuffer, CAN_RX_SESSION_STREAM_BUFFER_SIZE,
+			numSessionFrames);
+
+		//	copy received frames into front and session buffers, keeping their order
+		pFrontBuffer = MatrixReceiver.streamBuffer + CAN_RX_STREAM_BUFFER_FRONT_SIZE
+			- (numNewFrames - numSessionFrames);
+		pSessionBuffer = MatrixReceiver.sessionStreamBuffer + CAN_RX_SESSION_STREAM_BUFFER_SIZE
+			- numSessionFrames;
+		n = numNewFrames;
+		while (n--)
 		{
-			*pFrontBuffer++ =	MatrixReceiver.rxBuffer[MatrixReceiver.rxBufferReadIndex];
+			pFrame = &MatrixReceiver.rxBuffer[MatrixReceiver.rxBufferReadIndex];
+			if ((0 != MatrixReceiver.sessionAddress) && (pFrame->senderAddress == MatrixReceiver.sessionAddress))
+				*pSessionBuffer++ = *pFrame;
+			else
+				*pFrontBuffer++ = *pFrame;
 			if (++MatrixReceiver.rxBufferReadIndex >= CAN_RX_STREAM_BUFFER_BACK_SIZE)
 				MatrixReceiver.rxBufferReadIndex = 0;
 		}
 		
-		//	process the messages in the stream
-		ProcessMessagesInStream(numNewFrames);
+		//	process the messages in the streams
+		if (numNewFrames != numSessionFrames)
+			ProcessMessagesInStream(MatrixReceiver.streamBuffer, CAN_RX_STREAM_BUFFER_FRONT_SIZE,
+				numNewFrames - numSessionFrames);
+		if (0 != numSessionFrames)
+			ProcessMessagesInStream(MatrixReceiver.sessionStreamBuffer, CAN_RX_SESSION_STREAM_BUFFER_SIZE,
+				numSessionFrames);
 	}
 }
 
 /**
-  * @brief  Set the receiver sender address filter.
-	*					The sender address filter is normally zero to receive message from all senders,
-	*					and is reset to zero periodically.
-  * @param  senderAddressFilter.
+  * @brief  Sets the receiver ftp session peer address.
+	*					Messages from the session peer are reassembled in their own stream buffer,
+	*					so that traffic from other senders cannot displace them.
+	*					The session address is normally zero, and is reset to zero periodically.
+  * @param  sessionAddress: The ftp session peer address, or zero to end the session.
   * @retval None.
   */
-void MatrixReceiver_SetSenderAddressFilter(uint8_t senderAddressFilter)
+void MatrixReceiver_SetSessionAddress(uint8_t sessionAddress)
 {
 	//	set the address
-	MatrixReceiver.senderAddressFilter = senderAddressFilter;
+	MatrixReceiver.sessionAddress = sessionAddress;
 	
-	//	start the sender address filter timer
+	//	start the session timer
 	//	each time this timer expires it automatically re-starts
-	MatrixReceiver.senderAddressFilterTimeout =
-		Matrix.systemTime + MATRIX_MAX_SENDER_ADDRESS_FILTER_TIME_MS;
+	MatrixReceiver.sessionTimeout =
+		Matrix.systemTime + MATRIX_MAX_RX_SESSION_TIME_MS;
 }
 
 
@@ -153,12 +196,34 @@ void MatrixReceiver_SetSenderAddressFilter(uint8_t senderAddressFilter)
 
 uint8_t breakPoint, *pBreakPoint;
 
+/**
+  * @brief  Shifts the frames in a stream buffer toward the front to make room at the end.
+  *         The oldest frames are discarded.
+	* @param  streamBuffer: The stream buffer.
+	* @param  streamBufferSize: The stream buffer size in frames.
+	* @param  numNewFrames: The number of new frames to make room for.
+  * @retval None.
+  */
+static void ShiftStream(MATRIX_RX_CAN_FRAME *streamBuffer, uint16_t streamBufferSize,
+	uint16_t numNewFrames)
+{
+	if (0 == numNewFrames)
+		return;
+	if (numNewFrames > streamBufferSize)
+		numNewFrames = streamBufferSize;
+	memmove(streamBuffer, streamBuffer + numNewFrames,
+		(streamBufferSize - numNewFrames) * sizeof(MATRIX_RX_CAN_FRAME));
+}
+
 /**
   * @brief  Processes the messages in the stream.
+	* @param  streamBuffer: The stream buffer.
+	* @param  streamBufferSize: The stream buffer size in frames.
 	* @param  numNewFrames: the number of new frames received.
   * @retval None.
   */
-static void ProcessMessagesInStream(uint16_t numNewFrames)
+static void ProcessMessagesInStream(MATRIX_RX_CAN_FRAME *streamBuffer, uint16_t streamBufferSize,
+	uint16_t numNewFrames)
 {
 	MATRIX_RX_CAN_FRAME *messageFrame, *nextMessageFrame, *frame, *lastFrame;
 	TOKEN token;
@@ -168,14 +233,14 @@ static void ProcessMessagesInStream(uint16_t numNewFrames)
     bool isCommand;
 	
 	//	remove unprocessed frames from partial messages
-	RemoveUnprocessedFrames();
+	RemoveUnprocessedFrames(streamBuffer, streamBufferSize);
 	
 	//	sort the new frames
-	SortNewFrames(numNewFrames);
+	SortNewFrames(streamBuffer, streamBufferSize, numNewFrames);
 
 	//	starting with oldest frames, search for complete messages
-	messageFrame = MatrixReceiver.streamBuffer;
-	lastFrame = MatrixReceiver.streamBuffer + CAN_RX_STREAM_BUFFER_FRONT_SIZE;
+	messageFrame = streamBuffer;
+	lastFrame = streamBuffer + streamBufferSize;
 	while (messageFrame < lastFrame)
 	{
 		//	advance to used frame
@@ -237,6 +302,9 @@ static void ProcessMessagesInStream(uint16_t numNewFrames)
 			//	if message checksum is valid
 			if ((numMessageFrames == 1) || Matrix_IsMessageChecksumValid(messageFrame->data, numMessageBytes))
 			{
+				//	the sender is online
+				MatrixNodeTable_NodeSeen((uint8_t)messageFrame->senderAddress);
+				
 				//	remove checksum from message length
 				if (CAN_FRAME_MAX_NUM_BYTES < numMessageBytes)
 					numMessageBytes -= MATRIX_MESSAGE_CRC_SIZE;
@@ -301,9 +369,9 @@ static void ProcessMessagesInStream(uint16_t numNewFrames)
 			}
 				
 			//	erase message in message stream
-			memmove(MatrixReceiver.streamBuffer + numMessageFrames, MatrixReceiver.streamBuffer,
-				(uintptr_t)messageFrame - (uintptr_t)MatrixReceiver.streamBuffer);
-			memset(MatrixReceiver.streamBuffer, 0, numMessageFrames * sizeof(MATRIX_RX_CAN_FRAME));
+			memmove(streamBuffer + numMessageFrames, streamBuffer,
+				(uintptr_t)messageFrame - (uintptr_t)streamBuffer);
+			memset(streamBuffer, 0, numMessageFrames * sizeof(MATRIX_RX_CAN_FRAME));
 		}
 		
 		//	next message
@@ -314,48 +382,52 @@ static void ProcessMessagesInStream(uint16_t numNewFrames)
 /**
   * @brief  Removes unprocessed frames that have been in the buffer for longer than 500mS.
   *         Note that this is an exception because processed frames are already removed.
-	* @param  None.
+	* @param  streamBuffer: The stream buffer.
+	* @param  streamBufferSize: The stream buffer size in frames.
   * @retval None.
   */
-static void RemoveUnprocessedFrames(void)
+static void RemoveUnprocessedFrames(MATRIX_RX_CAN_FRAME *streamBuffer, uint16_t streamBufferSize)
 {
 	MATRIX_RX_CAN_FRAME *pFrame;
 
 	
 	//	for all active frames
-	pFrame = MatrixReceiver.streamBuffer + CAN_RX_STREAM_BUFFER_FRONT_SIZE;
-	while (--pFrame >= MatrixReceiver.streamBuffer)
+	pFrame = streamBuffer + streamBufferSize;
+	while (--pFrame >= streamBuffer)
 	{
 		if ((pFrame->frameFlags != MR_FRAME_FLAG_NONE)
 			&& (((Matrix.systemTime - pFrame->timeStamp) & 0x0fff) > MATRIX_RECEIVED_FRAME_TIMEOUT_MS))
 		{
-			if (pFrame > MatrixReceiver.streamBuffer)
-				memmove(MatrixReceiver.streamBuffer + 1, MatrixReceiver.streamBuffer,
-					((uintptr_t)pFrame - (uintptr_t)MatrixReceiver.streamBuffer));
-			MatrixReceiver.streamBuffer[0].frameFlags = MR_FRAME_FLAG_NONE;
+			if (pFrame > streamBuffer)
+				memmove(streamBuffer + 1, streamBuffer,
+					((uintptr_t)pFrame - (uintptr_t)streamBuffer));
+			streamBuffer[0].frameFlags = MR_FRAME_FLAG_NONE;
 		}
 	}
 }
 
 /**
   * @brief  Sorts the new frames into the proper location within the stream back buffer.
-	* @param  numNewFrames: The number of new frames at the start of the back buffer.
+	* @param  streamBuffer: The stream buffer.
+	* @param  streamBufferSize: The stream buffer size in frames.
+	* @param  numNewFrames: The number of new frames at the end of the stream buffer.
   * @retval None.
   */
-static void SortNewFrames(uint16_t numNewFrames)
+static void SortNewFrames(MATRIX_RX_CAN_FRAME *streamBuffer, uint16_t streamBufferSize,
+	uint16_t numNewFrames)
 {
 	MATRIX_RX_CAN_FRAME *newFrame, *compareFrame, *lastFrame, tempFrame;
 	int16_t n;
 	bool matchFound;
 	
 	//	for all new frames
-	lastFrame = MatrixReceiver.streamBuffer + CAN_RX_STREAM_BUFFER_FRONT_SIZE;
+	lastFrame = streamBuffer + streamBufferSize;
 	newFrame = lastFrame - (numNewFrames + 1);
 	while (++newFrame < lastFrame)
 	{
 		//	try to find most recent frame from same source
 		compareFrame = newFrame;
-		while ((--compareFrame >= MatrixReceiver.streamBuffer)
+		while ((--compareFrame >= streamBuffer)
 			&& (compareFrame->frameFlags != MR_FRAME_FLAG_NONE))
 		{
 			//	if have one or more frames from same source
@@ -365,7 +437,7 @@ static void SortNewFrames(uint16_t numNewFrames)
 				n = 15;
 				matchFound = false;
 				++compareFrame;
-				while ((--compareFrame >= MatrixReceiver.streamBuffer)
+				while ((--compareFrame >= streamBuffer)
 					&& (compareFrame->frameFlags != MR_FRAME_FLAG_NONE)
 					&& (compareFrame->senderAddress == newFrame->senderAddress)
 					&& (--n >= 0))
@@ -387,10 +459,10 @@ static void SortNewFrames(uint16_t numNewFrames)
 				if (matchFound)
 				{
 					*compareFrame = *newFrame;
-					if (newFrame > MatrixReceiver.streamBuffer)
-						memmove(MatrixReceiver.streamBuffer + 1, MatrixReceiver.streamBuffer,
-							(uintptr_t)newFrame - (uintptr_t)MatrixReceiver.streamBuffer);
-					MatrixReceiver.streamBuffer[0].frameFlags = MR_FRAME_FLAG_NONE;
+					if (newFrame > streamBuffer)
+						memmove(streamBuffer + 1, streamBuffer,
+							(uintptr_t)newFrame - (uintptr_t)streamBuffer);
+					streamBuffer[0].frameFlags = MR_FRAME_FLAG_NONE;
 				}
 				
 				//	else if frame has new location, then move into place
@@ -429,15 +501,6 @@ void Matrix_ReceiveCanFrame(uint32_t id, uint8_t* data, uint8_t dataSize, uint32
 		|| (enetId.frameType > MATRIX_MESSAGE_FRAME_TYPE_LAST))
 		return;
 
-	//	source address filter
-	//
-	//	if a multi-frame message frame, and only listening to multi-frame messages from one sender,
-	//	and sender address does not match filter,	then return  (typically used for ftp)
-	if ((enetId.frameType != MATRIX_MESSAGE_FRAME_TYPE_SINGLE)
-		&& (0 != MatrixReceiver.senderAddressFilter)
-		&& (MatrixReceiver.senderAddressFilter != enetId.sourceAddress))
-		return;
-	
 	//	destination address filter
 	//
 	//	if not a broadcast message or a message to this device, then return
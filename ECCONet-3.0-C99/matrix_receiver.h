@@ -116,12 +116,16 @@ typedef struct
 	//	the incoming frame read index
 	volatile uint16_t rxBufferReadIndex;
 	
-	//	the address filter timeout
-	uint32_t senderAddressFilterTimeout;
+	//	ftp session peer stream buffer
+	//	frames from the session peer are reassembled here, apart from other senders
+	MATRIX_RX_CAN_FRAME sessionStreamBuffer[CAN_RX_SESSION_STREAM_BUFFER_SIZE];
 	
-	//	the sender address filter
-	//	this is normally zero to receive messages from all senders
-	uint8_t senderAddressFilter;
+	//	the session timeout
+	uint32_t sessionTimeout;
+	
+	//	the session peer address
+	//	this is zero when there is no ftp session
+	uint8_t sessionAddress;
 	
 	//	number of frames read 0
 	uint8_t numFramesRead0;
@@ -149,13 +153,14 @@ extern void MatrixReceiver_Reset(void);
 extern void MatrixReceiver_Clock(void);
 
 /**
-  * @brief  Set the receiver sender address filter.
-	*					The sender address filter is normally zero to receive message from all senders,
-	*					and is reset to zero periodically.
-  * @param  None.
+  * @brief  Sets the receiver ftp session peer address.
+	*					Messages from the session peer are reassembled in their own stream buffer,
+	*					so that traffic from other senders cannot displace them.
+	*					The session address is normally zero, and is reset to zero periodically.
+  * @param  sessionAddress: The ftp session peer address, or zero to end the session.
   * @retval None.
   */
-extern void MatrixReceiver_SetSenderAddressFilter(uint8_t senderAddressFilter);
+extern void MatrixReceiver_SetSessionAddress(uint8_t sessionAddress);
 
 #endif  //  __MATRIX_RECEIVER_H
 
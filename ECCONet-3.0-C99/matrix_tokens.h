@@ -243,6 +243,7 @@ typedef enum
 	KeyRequestFileDelete,
 	KeyRequestFileTransferComplete,
 	KeyRequestFileWriteFixedSegment,
+	KeyRequestFileDirectory,
 
 	//	ftp responses
 	KeyResponseFileIndexedInfo = Region_Base__FTP_Responses,
@@ -265,6 +266,7 @@ typedef enum
   KeyResponseFtpTransactionComplete,
 	KeyResponseFtpTransactionTimedOut,
 	KeyResponseFileWriteFixedSegment,
+	KeyResponseFileDirectory,
 
 	
 } TokenKeys;
@@ -327,6 +329,8 @@ typedef enum
 #define TOKEN_VALUE_INVOKE_BOOTLOADER					0x5633870B
 #define TOKEN_VALUE_ERASE_APP_FIRMWARE				0x6A783B52
 #define TOKEN_VALUE_ERASE_ALL_FIRMWARE				0xB8E0123C
+#define TOKEN_VALUE_ALLOW_STATUS							0x320CCAEC
+#define TOKEN_VALUE_SUPPRESS_STATUS						0xA7CA28EE
 
 
 /**
@@ -166,6 +166,39 @@ void MatrixTransmitter_AddByte(uint8_t byte)
 		SendFrame();
 }
 
+/**
+  * @brief  Adds a block of bytes to the transmit fifo and accumulates the crc.
+	*					Frames are filled directly from the given data as the fifo fills,
+	*					so the data may be read straight from pointer-accessible flash.
+	* @param  data: A pointer to the bytes to add.
+	* @param  size: The number of bytes to add.
+  * @retval None.
+  */
+void MatrixTransmitter_AddBytes(const uint8_t *data, uint32_t size)
+{
+	uint32_t i, n;
+
+	//	validate input
+	if (NULL == data)
+		return;
+
+	while (0 != size)
+	{
+		//	copy as many bytes as fit in the fifo
+		n = MIN(size, (uint32_t)(CAN_TX_STREAM_FIFO_SIZE - MatrixTransmitter.fifoIndex));
+		memcpy(&MatrixTransmitter.fifo[MatrixTransmitter.fifoIndex], data, n);
+		for (i = 0; i < n; ++i)
+			Matrix_AddByteToCRC16(data[i], &MatrixTransmitter.crc);
+		MatrixTransmitter.fifoIndex += n;
+		data += n;
+		size -= n;
+
+		//	if fifo is full, then send CAN frame
+		if (CAN_TX_STREAM_FIFO_SIZE <= MatrixTransmitter.fifoIndex)
+			SendFrame();
+	}
+}
+
 /**
   * @brief  Adds a 16-bit value to the transmit fifo and accumulates the crc.
 	*					If the fifo is then full, sends a CAN frame.
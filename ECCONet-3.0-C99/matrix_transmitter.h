@@ -121,6 +121,16 @@ extern void MatrixTransmitter_StartMessageWithAddressAndKey(uint8_t destinationA
   */
 extern void MatrixTransmitter_AddByte(uint8_t byte);
 
+/**
+  * @brief  Adds a block of bytes to the transmit fifo and accumulates the crc.
+	*					Frames are filled directly from the given data as the fifo fills,
+	*					so the data may be read straight from pointer-accessible flash.
+	* @param  data: A pointer to the bytes to add.
+	* @param  size: The number of bytes to add.
+  * @retval None.
+  */
+extern void MatrixTransmitter_AddBytes(const uint8_t *data, uint32_t size);
+
 /**
   * @brief  Adds a 16-bit value to the transmit fifo and accumulates the crc.
 	*					If the fifo is then full, sends a CAN frame.